@@ -213,7 +213,6 @@ public:
     typedef Set<const CHNode*> CHNodeSetTy;
     typedef FIFOWorkList<const CHNode*> WorkList;
     typedef Map<std::string, CHNodeSetTy> NameToCHNodesMap;
-    typedef Map<CallSite, CHNodeSetTy> CallSiteToCHNodesMap;
     typedef Map<CallSite, VTableSet> CallSiteToVTableSetMap;
     typedef Map<CallSite, VFunSet> CallSiteToVFunSetMap;
 
@@ -268,15 +267,35 @@ public:
         else
             templateNameToInstancesMap[templateName].insert(node);
     }
-    inline const CHNodeSetTy &getDescendants(const std::string className)
-    {
-        return classNameToDescendantsMap[className];
-    }
     inline const CHNodeSetTy &getInstances(const std::string className)
     {
         return templateNameToInstancesMap[className];
     }
 
+    /// Classes are numbered in DFS order from base to derived classes (see CHGBuilder::buildClassHierarchyClosure),
+    /// so that the descendants of a class mostly have consecutive numbers
+    //@{
+    inline u32_t getDFSOrder(const CHNode* node) const
+    {
+        return classToDFSOrder[node->getId()];
+    }
+    inline const CHNode* getClassByDFSOrder(u32_t order) const
+    {
+        return dfsOrderToClass[order];
+    }
+    //@}
+    /// A class with its template instances and its descendants (and the ones of its instances), as DFS orders
+    inline const NodeBS& getClassClosure(const CHNode* node) const
+    {
+        return classClosure[node->getId()];
+    }
+    /// Vtables of the classes in the closure of a class
+    const VTableSet& getCHAVtbls(const CHNode* node);
+    /// Virtual functions at an index of the vtables of the classes in the closure of a class
+    const CHNode::FuncVector& getCHAVFns(const CHNode* node, u32_t idx);
+    /// Virtual functions which may be called at callsite "cs" whose this pointer is of the class of node
+    void getVFnsFromCHA(CallSite cs, const CHNode* node, VFunSet &virtualFunctions);
+
     inline bool csHasVtblsBasedonCHA(CallSite cs) override
     {
         CallSiteToVTableSetMap::const_iterator it = csToCHAVtblsMap.find(cs);
@@ -312,11 +331,28 @@ private:
     s32_t vfID;
     double buildingCHGTime;
     Map<std::string, CHNode *> classNameToNodeMap;
-    NameToCHNodesMap classNameToDescendantsMap;
-    NameToCHNodesMap classNameToAncestorsMap;
-    NameToCHNodesMap classNameToInstAndDescsMap;
     NameToCHNodesMap templateNameToInstancesMap;
-    CallSiteToCHNodesMap csToClassesMap;
+
+    /// Transitive closure of the class hierarchy, indexed by class (node) id
+    //@{
+    std::vector<u32_t> classToDFSOrder;
+    std::vector<const CHNode*> dfsOrderToClass;
+    std::vector<NodeBS> classClosure;
+    //@}
+    /// Vtables and virtual functions of the closure of a class, indexed by class id (and vtable index), built on demand
+    //@{
+    struct VFnTableEntry
+    {
+        bool built;
+        CHNode::FuncVector vfns;
+        VFnTableEntry(): built(false)
+        {
+        }
+    };
+    std::vector<VTableSet> classToCHAVtbls;
+    std::vector<bool> classToCHAVtblsBuilt;
+    std::vector<std::vector<VFnTableEntry>> classToCHAVFnTable;
+    //@}
 
     Map<const SVFFunction*, s32_t> virtualFunctionToIDMap;
     CallSiteToVTableSetMap csToCHAVtblsMap;
@@ -157,6 +157,10 @@ public:
         addGNode(node->getId(),node);
     }
 
+    /// Add an intra/call/ret node created elsewhere (e.g., by ICFGBuilder's worker threads)
+    /// with an id taken from totalICFGNode, and map its instruction to it
+    void addBlockICFGNode(ICFGNode* node);
+
     /// Get a basic block ICFGNode
     /// TODO:: need to fix the assertions
     //@{
@@ -53,6 +53,7 @@ protected:
     NodeSet refNodes;
     NodeToRepMap nodeToRefMap;  // a --> *a
     NodeToRepMap norToRepMap;   // for each *a construct a --> rep, i.e., mapping a node of to a rep node for online constraint solving
+    NodeToRepMap peRepMap;      // a --> rep, for nodes whose points-to sets are found equal by offline variable substitution
 
 public:
     OfflineConsG(SVFIR *p) : ConstraintGraph(p),
@@ -103,6 +104,20 @@ public:
     void buildOfflineMap(OSCC* oscc);
     //@}
 
+    // Offline variable substitution (HU)
+    // Each node is labelled with the set of points-to sources flowing into it: the objects
+    // of its address constraints, and a fresh label for every node whose points-to set is not
+    // known offline (ref nodes, gep destinations, 'onlineNodes' which get new constraints during
+    // solving). Nodes with the same non-empty label set are pointer-equivalent.
+    //{@
+    void solvePointerEquivalence(OSCC* oscc, const NodeBS& onlineNodes);
+    // Get the node to pointer-equivalence rep map (only nodes merged into another node are in the map)
+    inline const NodeToRepMap& getPERepMap() const
+    {
+        return peRepMap;
+    }
+    //@}
+
     // Dump graph into dot file
     void dump(std::string name);
 
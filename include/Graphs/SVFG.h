@@ -250,6 +250,12 @@ public:
         return addVFGEdge(edge);
     }
 
+    /// Re-point the definition of a top-level variable whose def node is about to be removed
+    inline void resetDef(const PAGNode* pagNode, const SVFGNode* node)
+    {
+        PAGNodeToDefMap[pagNode] = node->getId();
+    }
+
     /// Return total SVFG node number
     inline u32_t getSVFGNodeNum() const {
         return nodeNum;
@@ -156,6 +156,14 @@ public:
         svfgOptTimeEnd = PTAStat::getClk(true);
     }
 
+    /// Record the reduction of collapsing top-level copy cycles (-fs-collapse-copy-scc)
+    void collapsedTopLevelSCCs(u32_t vars, u32_t nodes, u32_t edges)
+    {
+        numOfCollapsedVars = vars;
+        numOfCollapsedNodes = nodes;
+        numOfCollapsedEdges = edges;
+    }
+
 private:
     void clear();
 
@@ -201,6 +209,10 @@ private:
     int totalDirCallEdge;
     int totalDirRetEdge;
 
+    u32_t numOfCollapsedVars;	///< number of top-level variables merged into a representative
+    u32_t numOfCollapsedNodes;	///< number of copy/phi svfg nodes removed by collapsing
+    u32_t numOfCollapsedEdges;	///< number of svfg edges removed (net) by collapsing
+
     int avgWeight;	///< average weight.
 
     int avgInDegree;	///< average in degrees of SVFG nodes.
@@ -20,6 +20,7 @@ namespace SVF
 
 class MHP;
 class LockAnalysis;
+class PCG;
 
 
 class SVFGNodeLockSpan {
@@ -73,6 +74,7 @@ public:
     typedef Set<const Instruction*> InstSet;
     typedef std::pair<NodeID,NodeID> NodeIDPair;
     typedef Map<SVFGNodeLockSpan, bool> PairToBoolMap;
+    typedef Map<NodeID, SVFGNodeIDSet> ObjToSVFGNodesMap;
     
     /// Constructor
     MTASVFGBuilder(MHP* m, LockAnalysis* la) : SVFGBuilder(), mhp(m), lockana(la)
@@ -102,6 +104,10 @@ private:
     SVFGEdge* addTDEdges(NodeID srcId, NodeID dstId, PointsTo& pts);
     /// Connect MHP indirect value-flow edges for two nodes that may-happen-in-parallel
     void connectMHPEdges(PointerAnalysis* pta);
+    /// Examine every store-load and store-store pair (non-sparse and no-alias models)
+    void connectMHPEdgesForAllPairs(PointerAnalysis* pta, PCG* pcg);
+    /// Examine only the store-load and store-store pairs accessing a common abstract object
+    void connectMHPEdgesForCandidatePairs(PointerAnalysis* pta);
 
     void handleStoreLoadNonSparse(const StmtSVFGNode* n1,const StmtSVFGNode* n2, PointerAnalysis* pta);
     void handleStoreStoreNonSparse(const StmtSVFGNode* n1,const StmtSVFGNode* n2, PointerAnalysis* pta);
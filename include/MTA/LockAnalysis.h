@@ -58,8 +58,22 @@ public:
 
     typedef Map<const Instruction*, CxtStmtSet> InstToCxtStmt;
 
+    /// Interned locksets: a lockset is a bit-vector over context-sensitive lock ids
+    //@{
+    typedef u32_t LockSetID;
+    typedef Map<CxtLock, NodeID> CxtLockToID;
+    typedef Map<CxtStmt, NodeID> CxtStmtToID;
+    typedef Map<CxtStmt, LockSetID> CxtStmtToLockSetID;
+    typedef OrderedMap<LockSet, LockSetID, SVFUtil::equalNodeBS> LockSetToID;
+    typedef std::pair<LockSetID, LockSetID> LockSetPair;
+    typedef Map<LockSetPair, LockSetID> LockSetPairToLockSetID;
+    typedef Map<LockSetPair, bool> LockSetPairToBool;
+    //@}
+
     LockAnalysis(TCT* t) : tct(t), lockTime(0),numOfTotalQueries(0), numOfLockedQueries(0), lockQueriesTime(0)
     {
+        /// the empty lockset always has id 0
+        internLockSet(LockSet());
     }
 
     /// context-sensitive forward traversal from each lock site. Generate following results
@@ -130,44 +144,32 @@ public:
     inline void addCxtLock(const CallStrCxt& cxt,const Instruction* inst)
     {
         CxtLock cxtlock(cxt,inst);
-        cxtLockset.insert(cxtlock);
+        if(cxtLockToId.emplace(cxtlock, idToCxtLock.size()).second)
+        {
+            idToCxtLock.push_back(cxtlock);
+            lockSpans.push_back(NodeBS());
+        }
         DBOUT(DMTA, SVFUtil::outs() << "LockAnalysis Process new lock "; cxtlock.dump());
     }
 
     /// Get context-sensitive lock
     inline bool hasCxtLock(const CxtLock& cxtLock) const
     {
-        return cxtLockset.find(cxtLock)!=cxtLockset.end();
+        return cxtLockToId.find(cxtLock)!=cxtLockToId.end();
+    }
+    inline const CxtLock& getCxtLock(NodeID lockId) const
+    {
+        assert(lockId < idToCxtLock.size() && "context-sensitive lock not found!");
+        return idToCxtLock[lockId];
     }
 
     /// Return true if the intersection of two locksets is not empty
-    inline bool intersects(const CxtLockSet& lockset1,const CxtLockSet& lockset2) const
+    inline bool intersects(LockSetID lockset1, LockSetID lockset2) const
     {
-        for(CxtLockSet::const_iterator it = lockset1.begin(), eit = lockset1.end(); it!=eit; ++it)
-        {
-            const CxtLock& lock = *it;
-            for(CxtLockSet::const_iterator lit = lockset2.begin(), elit = lockset2.end(); lit!=elit; ++lit)
-            {
-                if(lock==*lit)
-                    return true;
-            }
-        }
-        return false;
+        return idToLockSet[lockset1].intersects(idToLockSet[lockset2]);
     }
     /// Return true if two locksets has at least one alias lock
-    inline bool alias(const CxtLockSet& lockset1,const CxtLockSet& lockset2)
-    {
-        for(CxtLockSet::const_iterator it = lockset1.begin(), eit = lockset1.end(); it!=eit; ++it)
-        {
-            const CxtLock& lock = *it;
-            for(CxtLockSet::const_iterator lit = lockset2.begin(), elit = lockset2.end(); lit!=elit; ++lit)
-            {
-                if(isAliasedLocks(lock,*lit))
-                    return true;
-            }
-        }
-        return false;
-    }
+    bool alias(LockSetID lockset1, LockSetID lockset2);
     //@}
 
     /// Return true if it is a candidate function
@@ -192,56 +194,67 @@ public:
     }
     inline bool hasCxtLockfromCxtStmt(const CxtStmt& cts) const
     {
-        CxtStmtToCxtLockSet::const_iterator it = cxtStmtToCxtLockSet.find(cts);
-        return (it != cxtStmtToCxtLockSet.end());
+        CxtStmtToLockSetID::const_iterator it = cxtStmtToLockSetId.find(cts);
+        return (it != cxtStmtToLockSetId.end());
     }
-    inline const CxtLockSet& getCxtLockfromCxtStmt(const CxtStmt& cts) const
+    inline LockSetID getLockSetIDfromCxtStmt(const CxtStmt& cts) const
     {
-        CxtStmtToCxtLockSet::const_iterator it = cxtStmtToCxtLockSet.find(cts);
-        assert(it != cxtStmtToCxtLockSet.end());
+        CxtStmtToLockSetID::const_iterator it = cxtStmtToLockSetId.find(cts);
+        assert(it != cxtStmtToLockSetId.end());
         return it->second;
     }
-    inline CxtLockSet& getCxtLockfromCxtStmt(const CxtStmt& cts)
+    /// Lock ids of the lockset of a context-sensitive statement
+    inline const LockSet& getCxtLockfromCxtStmt(const CxtStmt& cts) const
     {
-        CxtStmtToCxtLockSet::iterator it = cxtStmtToCxtLockSet.find(cts);
-        assert(it != cxtStmtToCxtLockSet.end());
-        return it->second;
+        return idToLockSet[getLockSetIDfromCxtStmt(cts)];
     }
     /// Add context-sensitive statement
     inline bool addCxtStmtToSpan(const CxtStmt& cts, const CxtLock& cl)
     {
-        cxtLocktoSpan[cl].insert(cts);
-        return cxtStmtToCxtLockSet[cts].insert(cl).second;
+        CxtLockToID::const_iterator it = cxtLockToId.find(cl);
+        assert(it != cxtLockToId.end() && "context-sensitive lock not found!");
+        NodeID lockId = it->second;
+        spannedLocks.set(lockId);
+        lockSpans[lockId].set(getCxtStmtID(cts));
+        LockSetID& lsId = cxtStmtToLockSetId[cts];
+        if(idToLockSet[lsId].test(lockId))
+            return false;
+        LockSet lockset = idToLockSet[lsId];
+        lockset.set(lockId);
+        lsId = internLockSet(lockset);
+        return true;
     }
     /// Add context-sensitive statement
     inline bool removeCxtStmtToSpan(CxtStmt& cts, const CxtLock& cl)
     {
-        bool find = cxtStmtToCxtLockSet[cts].find(cl)!=cxtStmtToCxtLockSet[cts].end();
+        LockSetID& lsId = cxtStmtToLockSetId[cts];
+        CxtLockToID::const_iterator it = cxtLockToId.find(cl);
+        bool find = it!=cxtLockToId.end() && idToLockSet[lsId].test(it->second);
         if(find)
         {
-            cxtStmtToCxtLockSet[cts].erase(cl);
-            cxtLocktoSpan[cl].erase(cts);
+            LockSet lockset = idToLockSet[lsId];
+            lockset.reset(it->second);
+            lsId = internLockSet(lockset);
+            lockSpans[it->second].reset(getCxtStmtID(cts));
         }
         return find;
     }
-	
-	CxtStmtToCxtLockSet getCSTCLS() {
-		return cxtStmtToCxtLockSet;
-	}
+
+    /// Map each context-sensitive statement to its context-sensitive locks
+    CxtStmtToCxtLockSet getCSTCLS() const;
     /// Touch this context statement
     inline void touchCxtStmt(CxtStmt& cts)
     {
-        cxtStmtToCxtLockSet[cts];
+        cxtStmtToLockSetId[cts];
     }
-    inline bool hasSpanfromCxtLock(const CxtLock& cl)
+    /// Whether a statement was ever added to the span of a lock (the span may be empty again)
+    inline bool hasSpanfromCxtLock(const CxtLock& cl) const
     {
-        return cxtLocktoSpan.find(cl) != cxtLocktoSpan.end();
-    }
-    inline LockSpan& getSpanfromCxtLock(const CxtLock& cl)
-    {
-        assert(cxtLocktoSpan.find(cl) != cxtLocktoSpan.end());
-        return cxtLocktoSpan[cl];
+        CxtLockToID::const_iterator it = cxtLockToId.find(cl);
+        return it != cxtLockToId.end() && spannedLocks.test(it->second);
     }
+    /// Statements of a lock span, the span is kept as a bit-vector over context-sensitive statement ids
+    LockSpan getSpanfromCxtLock(const CxtLock& cl) const;
     //@}
 
 
@@ -293,7 +306,11 @@ public:
 
     inline u32_t getNumOfCxtLocks()
     {
-        return cxtLockset.size();
+        return idToCxtLock.size();
+    }
+    inline u32_t getNumOfLockSets()
+    {
+        return idToLockSet.size();
     }
     /// Print locks and spans
     void printLocks(const CxtStmt& cts);
@@ -334,37 +351,50 @@ private:
     /// Transfer function for marking context-sensitive statement
     void markCxtStmtFlag(const CxtStmt& tgr, const CxtStmt& src)
     {
-        const CxtLockSet& srclockset = getCxtLockfromCxtStmt(src);
-        if(hasCxtLockfromCxtStmt(tgr)== false)
+        LockSetID srclockset = getLockSetIDfromCxtStmt(src);
+        CxtStmtToLockSetID::iterator it = cxtStmtToLockSetId.find(tgr);
+        if(it == cxtStmtToLockSetId.end())
         {
-            for(CxtLockSet::const_iterator it = srclockset.begin(), eit = srclockset.end(); it!=eit; ++it)
+            NodeID stmtId = getCxtStmtID(tgr);
+            const LockSet& locks = idToLockSet[srclockset];
+            for(LockSet::iterator lit = locks.begin(), elit = locks.end(); lit!=elit; ++lit)
             {
-                addCxtStmtToSpan(tgr,*it);
+                lockSpans[*lit].set(stmtId);
             }
+            spannedLocks |= locks;
+            cxtStmtToLockSetId[tgr] = srclockset;
             pushToCTSWorkList(tgr);
         }
         else
         {
-            if(intersect(getCxtLockfromCxtStmt(tgr),srclockset))
+            LockSetID newlockset = intersect(it->second,srclockset);
+            if(newlockset != it->second)
+            {
+                it->second = newlockset;
                 pushToCTSWorkList(tgr);
+            }
         }
     }
-    bool intersect(CxtLockSet& tgrlockset, const CxtLockSet& srclockset)
+    /// Memoised intersection of two interned locksets
+    LockSetID intersect(LockSetID lockset1, LockSetID lockset2);
+
+    /// Intern a lockset/context-sensitive statement
+    //@{
+    inline LockSetID internLockSet(const LockSet& lockset)
     {
-        CxtLockSet toBeDeleted;
-        for(CxtLockSet::const_iterator it = tgrlockset.begin(), eit = tgrlockset.end(); it!=eit; ++it)
-        {
-            if(srclockset.find(*it)==srclockset.end())
-                toBeDeleted.insert(*it);
-        }
-        for(CxtLockSet::const_iterator it = toBeDeleted.begin(), eit = toBeDeleted.end(); it!=eit; ++it)
-        {
-            tgrlockset.erase(*it);
-        }
-        if(!toBeDeleted.empty())
-            return true;
-        return false;
+        std::pair<LockSetToID::iterator, bool> res = lockSetToId.emplace(lockset, idToLockSet.size());
+        if(res.second)
+            idToLockSet.push_back(lockset);
+        return res.first->second;
     }
+    inline NodeID getCxtStmtID(const CxtStmt& cts)
+    {
+        std::pair<CxtStmtToID::iterator, bool> res = cxtStmtToId.emplace(cts, idToCxtStmt.size());
+        if(res.second)
+            idToCxtStmt.push_back(cts);
+        return res.first->second;
+    }
+    //@}
 
     /// Clear flags
     inline void clearFlagMap()
@@ -451,14 +481,32 @@ private:
     InstToCxtStmtSet instToCxtStmtSet;
 
 
-    /// Context-sensitive locks
-    CxtLockSet cxtLockset;
+    /// Context-sensitive locks and their ids
+    //@{
+    CxtLockToID cxtLockToId;
+    std::vector<CxtLock> idToCxtLock;
+    //@}
+
+    /// Ids of context-sensitive statements in lock spans
+    //@{
+    CxtStmtToID cxtStmtToId;
+    std::vector<CxtStmt> idToCxtStmt;
+    //@}
+
+    /// Interned locksets, and memoised intersections/alias checks between them
+    //@{
+    LockSetToID lockSetToId;
+    std::vector<LockSet> idToLockSet;
+    LockSetPairToLockSetID intersectCache;
+    LockSetPairToBool aliasCache;
+    //@}
 
-    /// Map a context-sensitive lock to its lock span statements
-    /// Map a context-sensitive statement to its context-sensitive lock
+    /// Map a context-sensitive lock id to its lock span statements (ids of context-sensitive statements)
+    /// Map a context-sensitive statement to its lockset id
     //@{
-    CxtLockToSpan cxtLocktoSpan;
-    CxtStmtToCxtLockSet cxtStmtToCxtLockSet;
+    std::vector<NodeBS> lockSpans;
+    NodeBS spannedLocks;
+    CxtStmtToLockSetID cxtStmtToLockSetId;
     //@}
 
     /// Following data structures are used for collecting context-sensitive locks
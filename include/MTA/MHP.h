@@ -10,11 +10,13 @@
 
 #include "MTA/TCT.h"
 #include "Util/SVFUtil.h"
+#include <mutex>
 namespace SVF
 {
 
 class ForkJoinAnalysis;
 class LockAnalysis;
+class PCG;
 
 /*!
  * This class serves as a base may-happen in parallel analysis for multithreaded program
@@ -37,6 +39,9 @@ public:
     typedef std::pair<const Function*,const Function*> FuncPair;
     typedef Map<FuncPair, bool> FuncPairToBool;
 
+    typedef std::vector<std::pair<NodeID,NodeBS> > InterleavingSignature; ///< distinct (thread, interleaving threads) of an instruction
+    typedef Map<const Instruction*, u32_t> InstToInterleavingClassMap;
+
     /// Constructor
     MHP(TCT* t);
 
@@ -49,6 +54,9 @@ public:
     /// Analyze thread interleaving
     void analyzeInterleaving();
 
+    /// Analyze thread interleaving by solving the threads of the same TCT depth concurrently (-mhp-threads)
+    void analyzeInterleavingInParallel();
+
     /// Get ThreadCallGraph
     inline ThreadCallGraph* getThreadCallGraph() const
     {
@@ -60,6 +68,12 @@ public:
     {
         return tct;
     }
+
+    /// Get the procedure-level MHP prefilter (nullptr unless -mhp-pcg-prefilter)
+    inline PCG* getPCG() const
+    {
+        return pcg;
+    }
 	
 	// Get CallBlockNode
 	inline CallBlockNode* getCBN(const Instruction* inst) {
@@ -85,6 +99,17 @@ public:
     virtual bool mayHappenInParallelInst(const Instruction* i1, const Instruction* i2);
     virtual bool executedByTheSameThread(const Instruction* i1, const Instruction* i2);
 
+    /// Interleaving classes (-mhp-query-classes)
+    /// Instructions with the same thread statements' interleavings share a class and have the same MHP relation
+    //@{
+    /// Collect all instructions which may happen in parallel with inst in one query
+    void getMHPInstructions(const Instruction* inst, InstSet& mhpInsts);
+    inline u32_t getInterleavingClassNum() const
+    {
+        return classToInsts.size();
+    }
+    //@}
+
     /// Get interleaving thread for statement inst
     //@{
     inline const NodeBS& getInterleavingThreads(const CxtThreadStmt& cts)
@@ -115,7 +140,39 @@ public:
     void printInterleaving();
 
 private:
-	
+
+    /*!
+     * Analysis state of the statements of one thread when interleavings are solved in parallel.
+     * A shard is only updated by the worker solving its thread, interleavings flowing
+     * into forked threads are buffered and applied after each round.
+     */
+    struct InterleavingShard
+    {
+        CxtThreadStmtWorkList worklist;                         ///< pending statements of this thread
+        ThreadStmtToThreadInterleav threadStmtToTheadInterLeav; ///< interleavings of the statements of this thread
+        InstToThreadStmtSetMap instToTSMap;                     ///< statements of this thread reached so far
+        std::vector<std::pair<CxtThreadStmt,NodeBS> > forkedInterleav; ///< interleavings propagated to the entries of forked threads
+    };
+    typedef std::vector<InterleavingShard> InterleavingShards;
+
+    /// Process a statement popped from the worklist
+    void processCxtThreadStmt(const CxtThreadStmt& cts, NodeID rootTid);
+
+    /// Drain the worklist of a thread's shard (parallel mode)
+    void solveInterleavingShard(NodeID tid);
+
+    /// Group threads by their depth in the TCT, parents always come before their children
+    void getThreadsByTCTDepth(std::vector<std::vector<NodeID> >& levels) const;
+
+    /// Merge the shards into threadStmtToTheadInterLeav and instToTSMap after parallel solving
+    void mergeInterleavingShards();
+
+    /// Assign interleaving classes to instructions and compute the MHP matrix between classes
+    void buildInterleavingClasses();
+
+    /// Whether instructions with the two interleaving signatures may happen in parallel
+    bool isMHPSignature(const InterleavingSignature& sig1, const InterleavingSignature& sig2);
+
 	inline const PTACallGraph::FunctionSet& getCallee(const Instruction* inst, PTACallGraph::FunctionSet& callees) {
         tcg->getCallees(getCBN(inst), callees);
         return callees;
@@ -147,23 +204,40 @@ private:
 
     /// Add/Remove interleaving thread for statement inst
     //@{
+    inline NodeBS& getInterleavingThreadsForUpdate(const CxtThreadStmt& cts)
+    {
+        if(solveInParallel)
+            return shards[cts.getTid()].threadStmtToTheadInterLeav[cts];
+        return threadStmtToTheadInterLeav[cts];
+    }
+    inline void addThreadStmt(const CxtThreadStmt& tgr)
+    {
+        if(solveInParallel)
+            shards[tgr.getTid()].instToTSMap[tgr.getStmt()].insert(tgr);
+        else
+            instToTSMap[tgr.getStmt()].insert(tgr);
+    }
     inline void addInterleavingThread(const CxtThreadStmt& tgr, NodeID tid)
     {
-        if(threadStmtToTheadInterLeav[tgr].test_and_set(tid))
+        if(getInterleavingThreadsForUpdate(tgr).test_and_set(tid))
         {
-            instToTSMap[tgr.getStmt()].insert(tgr);
+            addThreadStmt(tgr);
             pushToCTSWorkList(tgr);
         }
     }
-    inline void addInterleavingThread(const CxtThreadStmt& tgr, const CxtThreadStmt& src)
+    inline void addInterleavingThread(const CxtThreadStmt& tgr, const NodeBS& tids)
     {
-        bool changed = threadStmtToTheadInterLeav[tgr] |= threadStmtToTheadInterLeav[src];
+        bool changed = getInterleavingThreadsForUpdate(tgr) |= tids;
         if(changed)
         {
-            instToTSMap[tgr.getStmt()].insert(tgr);
+            addThreadStmt(tgr);
             pushToCTSWorkList(tgr);
         }
     }
+    inline void addInterleavingThread(const CxtThreadStmt& tgr, const CxtThreadStmt& src)
+    {
+        addInterleavingThread(tgr, getInterleavingThreadsForUpdate(src));
+    }
     inline void rmInterleavingThread(const CxtThreadStmt& tgr, const NodeBS& tids, const Instruction* joinsite)
     {
         NodeBS joinedTids;
@@ -172,7 +246,7 @@ private:
             if(isMustJoin(tgr.getTid(),joinsite))
                 joinedTids.set(*it);
         }
-        if(threadStmtToTheadInterLeav[tgr].intersectWithComplement(joinedTids))
+        if(getInterleavingThreadsForUpdate(tgr).intersectWithComplement(joinedTids))
         {
             pushToCTSWorkList(tgr);
         }
@@ -217,6 +291,8 @@ private:
     //@{
     inline bool pushToCTSWorkList(const CxtThreadStmt& cs)
     {
+        if(solveInParallel)
+            return shards[cs.getTid()].worklist.push(cs);
         return cxtStmtList.push(cs);
     }
     inline CxtThreadStmt popFromCTSWorkList()
@@ -248,15 +324,24 @@ private:
     ThreadCallGraph* tcg;				///< TCG
     TCT* tct;							///< TCT
     ForkJoinAnalysis* fja;				///< ForJoin Analysis
+    PCG* pcg;							///< Procedure-level MHP consulted before context-sensitive queries
     CxtThreadStmtWorkList cxtStmtList;	///< CxtThreadStmt worklist
     ThreadStmtToThreadInterleav threadStmtToTheadInterLeav; /// Map a statement to its thread interleavings
     InstToThreadStmtSetMap instToTSMap; ///< Map an instruction to its ThreadStmtSet
     FuncPairToBool nonCandidateFuncMHPRelMap;
+    InterleavingShards shards;          ///< Per-thread analysis state when solving in parallel
+    bool solveInParallel;               ///< Whether interleavings are being solved in parallel
+    std::mutex fjaMutex;                ///< Guard the join caches of ForkJoinAnalysis in parallel mode
+    InstToInterleavingClassMap instToClass;     ///< Map an instruction to its interleaving class
+    std::vector<InstVec> classToInsts;          ///< Instructions of each interleaving class
+    std::vector<NodeBS> classMHPMatrix;         ///< Row c: classes which may happen in parallel with class c
+    bool hasInterleavingClasses;                ///< Whether queries are answered by interleaving classes
 
 
 public:
     u32_t numOfTotalQueries;		///< Total number of queries
     u32_t numOfMHPQueries;			///< Number of queries are answered as may-happen-in-parallel
+    u32_t numOfPrefilteredQueries;	///< Number of queries answered by the procedure-level prefilter alone
     double interleavingTime;
     double interleavingQueriesTime;
 };
@@ -57,8 +57,8 @@ public:
     virtual MHP* computeMHP(SVFModule* module);
     /// Compute locksets
     virtual LockAnalysis* computeLocksets(TCT* tct);
-    /// Perform detection
-    virtual void detect(SVFModule* module);
+    /// Perform detection on the accesses that may happen in parallel, alias and are not protected by a common lock
+    virtual void detect(SVFModule* module, MHP* mhp, LockAnalysis* lsa);
 
     /// Pass name
     virtual StringRef getPassName() const
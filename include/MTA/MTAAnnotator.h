@@ -82,6 +82,9 @@ public:
     }
 
 private:
+    /// Whether two accesses are protected by a common lock, reported to the -mta-report sink
+    bool isProtectedByCommonLock(const Instruction* i1, const Instruction* i2);
+
     MHP* mhp;
     LockAnalysis* lsa;
     InstSet loadset;
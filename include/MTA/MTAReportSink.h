@@ -0,0 +1,127 @@
+/*
+ * MTAReportSink.h
+ *
+ * Streaming sink for the results of multithreaded program analysis
+ */
+
+#ifndef MTAREPORTSINK_H_
+#define MTAREPORTSINK_H_
+
+#include "Util/BasicTypes.h"
+#include <chrono>
+
+namespace SVF
+{
+
+/*!
+ * Emit MHP, lock, race and validation results one line at a time (-mta-report=<file>)
+ * instead of keeping them until the end of the analysis.
+ *
+ * Each line is tab separated: <KIND>\t<source loc 1>\t<source loc 2>\t<0|1>[\t<expected 0|1>],
+ * or NEEDCHECK\t<source loc> for an access in a pair that may race.
+ * Lines are buffered up to -mta-report-buffer KB and written out whenever the buffer is full,
+ * -mta-report-flush-ms milliseconds have passed since the last write, an analysis phase ends,
+ * or the program exits (including on the -*-time-limit timeouts), so the memory held for
+ * results is bounded and a run killed on timeout still leaves its partial results behind.
+ * When enabled, race results are only reported here: the annotator does not keep the racy
+ * accesses and the validators do not print their results.
+ */
+class MTAReportSink
+{
+
+public:
+    /// Kinds of reported results
+    enum ReportKind
+    {
+        MHPPair,
+        LockPair,
+        RacePair,
+        NeedCheck,
+        Validation
+    };
+
+    /// Singleton
+    static MTAReportSink* getReportSink()
+    {
+        if (reportSink == nullptr)
+            reportSink = new MTAReportSink();
+        return reportSink;
+    }
+    static void releaseReportSink()
+    {
+        delete reportSink;
+        reportSink = nullptr;
+    }
+
+    /// Whether a report file is given
+    inline bool isEnabled() const
+    {
+        return os != nullptr;
+    }
+
+    /// Report the result of a query on an instruction pair
+    //@{
+    inline void reportMHP(const Instruction* i1, const Instruction* i2, bool mhp)
+    {
+        if (isEnabled())
+            report(MHPPair, i1, i2, mhp);
+    }
+    inline void reportLock(const Instruction* i1, const Instruction* i2, bool protect)
+    {
+        if (isEnabled())
+            report(LockPair, i1, i2, protect);
+    }
+    inline void reportRace(const Instruction* i1, const Instruction* i2)
+    {
+        if (isEnabled())
+            report(RacePair, i1, i2, true);
+    }
+    //@}
+
+    /// Report an access in at least one pair that may race
+    void reportNeedCheck(const Instruction* inst);
+
+    /// Report the result of a validation scenario together with the expected result
+    void reportValidation(const char* scenario, const Instruction* i1, const Instruction* i2, bool res, bool expected);
+
+    /// Write out the buffered lines (called at the end of each analysis phase)
+    void flush();
+
+    /// Number of reported lines
+    inline u64_t getNumOfReports() const
+    {
+        return numOfReports;
+    }
+
+private:
+    /// Constructor
+    MTAReportSink();
+
+    /// Destructor
+    ~MTAReportSink();
+
+    void report(ReportKind kind, const Instruction* i1, const Instruction* i2, bool res);
+
+    /// Registered with atexit, as exiting on a time limit does not release the sink
+    static void flushAtExit();
+
+    /// Append a finished line, flush if the buffer or the time budget is exhausted
+    void append();
+
+    /// Source location of an instruction, cached (up to a fixed number of entries) since instructions are reported in many pairs
+    const std::string& getLoc(const Instruction* inst);
+
+    static MTAReportSink* reportSink;
+
+    raw_fd_ostream* os;             ///< output of -mta-report, nullptr if disabled
+    std::string buffer;             ///< lines not written out yet
+    std::string line;               ///< line being composed
+    Map<const Instruction*, std::string> instToLoc;
+    u64_t numOfReports;
+    u64_t bufferLimit;              ///< size of the buffer in bytes before it is written out
+    std::chrono::steady_clock::time_point lastFlush; ///< time of the last write
+};
+
+} // End namespace SVF
+
+#endif /* MTAREPORTSINK_H_ */
@@ -9,6 +9,7 @@
 #define MTARESULTVALIDATOR_H_
 
 #include "MTA/MHP.h"
+#include "MTA/MTAReportSink.h"
 
 /*!
  * Validate the result of context-sensitive analysis, including context-sensitive
@@ -316,6 +317,7 @@ protected:
     void validateAll()
     {
         SVFUtil::outs() << SVFUtil::pasMsg(" --- Analysis Result Validation ---\n");
+        MTAReportSink* sink = MTAReportSink::getReportSink();
 
         // Iterate every memory access pair to perform the validation.
         for (int i = 0, e = accessPairs.size(); i != e; ++i)
@@ -329,6 +331,20 @@ protected:
             bool protect = protectedByCommonLocks(I1, I2);
             bool racy = mayHaveDataRace(I1, I2);
 
+            /// streamed results are not printed
+            if (sink->isEnabled())
+            {
+                if (selectedValidationScenarios & RC_ALIASES)
+                    sink->reportValidation("ALIASES", I1, I2, alias, ap.isFlaged(RC_ALIASES));
+                if (selectedValidationScenarios & RC_MHP)
+                    sink->reportValidation("MHP", I1, I2, mhp, ap.isFlaged(RC_MHP));
+                if (selectedValidationScenarios & RC_PROTECTED)
+                    sink->reportValidation("PROTECT", I1, I2, protect, ap.isFlaged(RC_PROTECTED));
+                if (selectedValidationScenarios & RC_RACE)
+                    sink->reportValidation("RACE", I1, I2, racy, ap.isFlaged(RC_RACE));
+                continue;
+            }
+
             SVFUtil::outs() << "For the memory access pair at ("
                             << SVFUtil::getSourceLoc(I1) << ", "
                             << SVFUtil::getSourceLoc(I2) << ")\n";
@@ -357,6 +373,7 @@ protected:
             }
         }
 
+        sink->flush();
         SVFUtil::outs() << "\n";
     }
 
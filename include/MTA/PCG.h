@@ -34,6 +34,7 @@ public:
     typedef Set<const Instruction*> CallInstSet;
     typedef FIFOWorkList<const Function*> FunWorkList;
     typedef FIFOWorkList<const BasicBlock*> BBWorkList;
+    typedef Map<const Function*, u32_t> FunToIDMap;
 
 private:
     FunSet spawners;
@@ -48,6 +49,15 @@ private:
     /// Callsites direct or Indirect call a function which spawn a thread
     CallInstSet spawnCallSites;
 
+    /// Function x function MHP matrix over spawners, spawnees and followers,
+    /// other functions never happen in parallel with any function.
+    /// Two of them may happen in parallel iff either is a spawnee, so the matrix
+    /// is represented by one spawnee bit per function.
+    //@{
+    FunToIDMap funToMatrixID;
+    std::vector<bool> mhpFunSpawnees;
+    //@}
+
     /// Add/Get methods for thread properties of a procedure
     //@{
     inline bool isSpawnerFun(const Function* fun) const
@@ -132,6 +142,11 @@ public:
     /// Interface to query whether two function may happen-in-parallel
     virtual bool mayHappenInParallel(const Instruction* i1, const Instruction* i2) const;
     bool mayHappenInParallelBetweenFunctions(const Function* fun1, const Function* fun2) const;
+    /// Number of functions indexed by the MHP matrix
+    inline u32_t getMHPFunMatrixDim() const
+    {
+        return funToMatrixID.size();
+    }
     //bool mayHappenInParallel(const Function* fun1, const Function* fun2) const;
     inline const FunSet& getMHPFunctions() const
     {
@@ -150,6 +165,9 @@ public:
     void identifyFollowers();
     //@}
 
+    /// Compute the function x function MHP matrix once spawners, spawnees and followers are known
+    void buildMHPFunMatrix();
+
     /// Get spawners/spawnees/followers
     //@{
     inline const FunSet& getSpawners() const
@@ -15,6 +15,7 @@
 #include "SVF-FE/DataFlowUtil.h"
 #include <set>
 #include <vector>
+#include <atomic>
 
 namespace SVF
 {
@@ -393,7 +394,7 @@ private:
     PointerAnalysis* pta;
     u32_t TCTNodeNum;
     u32_t TCTEdgeNum;
-    u32_t MaxCxtSize;
+    std::atomic<u32_t> MaxCxtSize;
 
     /// Add TCT node
     inline TCTNode* addTCTNode(const CxtThread& ct)
@@ -456,6 +457,30 @@ private:
 
     /// Handle call relations
     void handleCallRelation(CxtThreadProc& ctp, const PTACallGraphEdge* cgEdge, CallSite call);
+    /// Handle a call relation whose callee context cxt has been computed
+    void handleCallRelation(CxtThreadProc& ctp, const PTACallGraphEdge* cgEdge, CallSite call, const CallStrCxt& cxt);
+
+    /// Parallel TCT construction (-tct-threads)
+    //@{
+    /// A (direct or indirect) call relation of a CxtThreadProc together with the callee context
+    struct CallRelation
+    {
+        CallRelation(const PTACallGraphEdge* e, const CallBlockNode* c, bool ind, const CallStrCxt& cx): cgEdge(e), call(c), indirect(ind), cxt(cx) {}
+        const PTACallGraphEdge* cgEdge;
+        const CallBlockNode* call;
+        bool indirect;
+        CallStrCxt cxt;
+    };
+    typedef std::vector<CallRelation> CallRelations;
+    /// Compute loop, dominator and post-dominator info of all candidate functions in parallel
+    void buildCFInfoForCandidateFuns();
+    /// Collect the call relations of a CxtThreadProc, without updating the TCT
+    void collectCallRelations(const CxtThreadProc& ctp, CallRelations& rels);
+    /// Handle the call relations collected for a CxtThreadProc, in order
+    void handleCallRelations(CxtThreadProc& ctp, const CallRelations& rels);
+    /// Drain the CxtThreadProc worklist round by round, expanding the procedures of a round concurrently
+    void expandCxtThreadProcsInParallel();
+    //@}
 
     /// Get or create a tct node based on CxtThread
     //@{
@@ -34,6 +34,7 @@
 #include "Util/SVFUtil.h"
 #include "MemoryModel/LocationSet.h"
 #include "Util/SVFModule.h"
+#include "Util/FlatIndexMap.h"
 namespace SVF
 {
 
@@ -65,15 +66,17 @@ public:
 
     /// various maps defined
     //{@
+    /// The maps below are looked up for every operand when building SVFIR, they are hash
+    /// indexed (FlatIndexMap) and iterated in the order their entries are added.
     /// llvm value to sym id map
     /// local (%) and global (@) identifiers are pointer types which have a value node id.
-    typedef OrderedMap<const Value *, SymID> ValueToIDMapTy;
+    typedef FlatIndexMap<const Value *, SymID> ValueToIDMapTy;
     /// sym id to memory object map
-    typedef OrderedMap<SymID,MemObj*> IDToMemMapTy;
+    typedef FlatIndexMap<SymID,MemObj*> IDToMemMapTy;
     /// function to sym id map
-    typedef OrderedMap<const Function *, SymID> FunToIDMapTy;
+    typedef FlatIndexMap<const Function *, SymID> FunToIDMapTy;
     /// struct type to struct info map
-    typedef OrderedMap<const Type*, StInfo*> TypeToFieldInfoMap;
+    typedef FlatIndexMap<const Type*, StInfo*> TypeToFieldInfoMap;
     typedef Set<CallSite> CallSiteSet;
     typedef OrderedMap<const Instruction*,CallSiteID> CallSiteToIDMapTy;
     typedef OrderedMap<CallSiteID,const Instruction*> IDToCallSiteMapTy;
@@ -379,6 +382,8 @@ public:
     u32_t getFields(std::vector<LocationSet>& fields, const Type* T, u32_t msz);
     /// Collect type info
     void collectTypeInfo(const Type* T);
+    /// Collect type info of types (and their element types) on multiple threads
+    void collectTypeInfo(const std::vector<const Type*>& types, u32_t numThreads);
     /// Given an offset from a Gep Instruction, return it modulus offset by considering memory layout
     virtual LocationSet getModulusOffset(const MemObj* obj, const LocationSet& ls);
 
@@ -398,6 +403,14 @@ protected:
     /// Collect simple type (non-aggregate) info
     virtual void collectSimpleTypeInfo(const Type* T);
 
+    /// Fill in the StInfo of a type using the given data layout, the StInfo of its element types are read
+    //@{
+    u32_t fillStructInfo(StInfo* stinfo, const StructType *T, const DataLayout& layout);
+    void fillArrayInfo(StInfo* stinfo, const ArrayType* T, const DataLayout& layout);
+    void fillSimpleTypeInfo(StInfo* stinfo, const Type* T);
+    u32_t getTypeInfoLevel(const Type* T, Map<const Type*, u32_t>& typeToLevel, std::vector<std::vector<const Type*>>& levels) const;
+    //@}
+
     /// Create an objectInfo based on LLVM type (value is null, and type could be null, representing a dummy object)
     ObjTypeInfo* createObjTypeInfo(const Type *type = nullptr);
 
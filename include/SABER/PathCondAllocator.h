@@ -53,9 +53,11 @@ public:
     typedef Map<u32_t,Condition*> CondPosMap;		///< map a branch to its Condition
     typedef Map<const BasicBlock*, CondPosMap > BBCondMap;	// map bb to a Condition
     typedef Set<const BasicBlock*> BasicBlockSet;
+    typedef Set<const Function*> FunctionSet;
     typedef Map<const Function*,  BasicBlockSet> FunToExitBBsMap;  ///< map a function to all its basic blocks calling program exit
     typedef Map<const BasicBlock*, Condition*> BBToCondMap;	///< map a basic block to its condition during control-flow guard computation
     typedef FIFOWorkList<const BasicBlock*> CFWorkList;	///< worklist for control-flow guard computation
+    typedef std::vector<std::pair<const BasicBlock*, Condition*>> SuccCondVec;	///< successors of a basic block and their conditions
 
 
     /// Constructor
@@ -76,6 +78,30 @@ public:
     {
         return condMgr->getCondNumber();
     }
+    inline u32_t getSatCacheHitNum() const
+    {
+        return condMgr->getSatCacheHitNum();
+    }
+    inline u32_t getSatCacheMissNum() const
+    {
+        return condMgr->getSatCacheMissNum();
+    }
+    inline double getSolverTime() const
+    {
+        return condMgr->getSolverTime();
+    }
+    inline u32_t getBddPeakNodeNum() const
+    {
+        return condMgr->getBddPeakNodeNum();
+    }
+    inline u32_t getBddReorderNum() const
+    {
+        return condMgr->getBddReorderNum();
+    }
+    inline u64_t getBddReorderTime() const
+    {
+        return condMgr->getBddReorderTime();
+    }
     //@}
 
     /// Condition operations
@@ -122,6 +148,16 @@ public:
     {
         return condMgr->createFreshBranchCond(inst);
     }
+    /// Translate a condition of another (e.g., per-thread) condition manager into this allocator's manager
+    inline Condition* translateCond(const Condition* cond, const CondManager* srcMgr)
+    {
+        return condMgr->translate(cond, srcMgr);
+    }
+    /// Get the condition manager used by this allocator
+    inline CondManager* getCondMgr() const
+    {
+        return condMgr;
+    }
     //@}
 
     /// Perform path allocation
@@ -204,9 +240,24 @@ public:
 
 private:
 
+    /// Allocate path conditions for every basic block of a function, if not yet allocated
+    void allocateForFun(const Function* fun);
+
+    /// Collect the basic blocks of a function in the order their condition variables are allocated (-bdd-var-order)
+    void getBBsInVarOrder(const Function* fun, std::vector<const BasicBlock*>& bbs);
+
+    /// Allocate path conditions for the functions on numThreads threads, each with its own condition manager (-path-cond-threads)
+    void allocateForFuns(const std::vector<const Function*>& funs, u32_t numThreads);
+
     /// Allocate path condition for every basic block
     virtual void allocateForBB(const BasicBlock& bb);
 
+    /// Number of decision variables of a basic block
+    static u32_t getNumOfBranchCondVars(const BasicBlock& bb);
+
+    /// Build the conditions of the successors of a basic block in a condition manager
+    static void getSuccConds(const BasicBlock& bb, CondManager* mgr, u32_t firstVar, SuccCondVec& succConds);
+
     /// Get/Set a branch condition, and its terminator instruction
     //@{
     /// Set branch condition
@@ -277,6 +328,7 @@ private:
     PTACFInfoBuilder cfInfoBuilder;		    ///< map a function to its loop info
     FunToExitBBsMap funToExitBBsMap;		///< map a function to all its basic blocks calling program exit
     BBToCondMap bbToCondMap;				///< map a basic block to its path condition starting from root
+    FunctionSet allocatedFuns;				///< functions whose branch conditions have been allocated
     const SVFGNode* curEvalSVFGNode{};			///< current llvm value to evaluate branch condition when computing guards
 
 protected:
@@ -77,13 +77,29 @@ private:
     {
         if(F)
         {
-            TDAPIMap::const_iterator it= tdAPIMap.find(F->getName().str());
+            TDAPIMap::const_iterator it= tdAPIMap.find(F->getName());
             if(it != tdAPIMap.end())
                 return it->second;
+            return getSpecType(F);
         }
         return CK_DUMMY;
     }
 
+    /// Get the function type of an allocator/deallocator summarised in -ext-api-spec
+    inline CHECKER_TYPE getSpecType(const SVFFunction* F) const
+    {
+        switch(ExtAPI::getExtAPI()->get_spec_type(F))
+        {
+        case ExtAPI::EFT_ALLOC:
+        case ExtAPI::EFT_NOSTRUCT_ALLOC:
+            return CK_ALLOC;
+        case ExtAPI::EFT_FREE:
+            return CK_FREE;
+        default:
+            return CK_DUMMY;
+        }
+    }
+
 public:
     /// Return a static reference
     static SaberCheckerAPI* getCheckerAPI()
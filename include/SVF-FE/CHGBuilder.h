@@ -56,13 +56,11 @@ public:
     void connectInheritEdgeViaCall(const SVFFunction* caller, CallSite cs);
     void connectInheritEdgeViaStore(const SVFFunction* caller, const StoreInst* store);
 
-    void buildClassNameToAncestorsDescendantsMap();
-    const CHGraph::CHNodeSetTy& getInstancesAndDescendants(const std::string className);
+    void buildClassHierarchyClosure();
 
     void analyzeVTables(const Module &M);
     void buildVirtualFunctionToIDMap();
     void buildCSToCHAVtblsAndVfnsMap();
-    const CHNodeSetTy& getCSClasses(CallSite cs);
     void addFuncToFuncVector(CHNode::FuncVector &v, const SVFFunction *f);
 };
 
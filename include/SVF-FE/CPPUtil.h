@@ -103,6 +103,10 @@ bool VCallInCtorOrDtor(CallSite cs);
  */
 bool isSameThisPtrInConstructor(const Argument* thisPtr1, const Value* thisPtr2);
 
+/// Clear the caches of demangled names and of class names/constructor kinds keyed by types
+/// and functions, which must not outlive the modules they were computed on
+void clearCaches();
+
 /// Constants pertaining to CTir, for C and C++.
 /// TODO: move helper functions here too?
 namespace ctir
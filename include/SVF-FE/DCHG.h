@@ -223,6 +223,10 @@ public:
     ///   DISubroutineType: shallow pointer equality.
     static bool teq(const DIType *t1, const DIType *t2);
 
+    /// Returns a structural hash of t, ignoring qualifiers, such that
+    /// teq(t1, t2) implies hashDIType(t1) == hashDIType(t2).
+    static size_t hashDIType(const DIType *t);
+
     /// Returns a human-readable version of the DIType.
     static std::string diTypeToStr(const DIType *);
 
@@ -370,12 +374,30 @@ protected:
     Map<const DIType *, const DIType *> canonicalTypeMap;
     /// Set of all possible canonical types (i.e. values of canonicalTypeMap).
     Set<const DIType *> canonicalTypes;
+    /// Canonical types bucketed by their structural hash (hashDIType).
+    Map<size_t, std::vector<const DIType *>> canonicalTypeBuckets;
     /// Maps types to their flattened fields' types.
     Map<const DIType *, std::vector<const DIType *>> fieldTypes;
     /// Maps aggregate types to all the aggregate types it transitively contains.
     Map<const DIType *, Set<const DIType *>> containingAggs;
 
 private:
+    /// What an aggregate is directly made of, the flattened fields and contained
+    /// aggregates of which are put together by flattenAndGatherAggs.
+    struct AggInfo
+    {
+        /// Canonical types of the fields in offset order (class/struct only),
+        /// paired with whether the field is a class/struct to be flattened in turn.
+        std::vector<std::pair<const DIType *, bool>> fields;
+        /// Canonical aggregates directly contained.
+        std::vector<const DIType *> aggs;
+        /// 1 + the largest level of the aggregates this one is made of.
+        u32_t level = 0;
+        /// Whether the fields and aggregates have been collected (false while recursing).
+        bool collected = false;
+    };
+    typedef Map<const DIType *, AggInfo> AggInfoMap;
+
     /// Construction helper to process DIBasicTypes.
     void handleDIBasicType(const DIBasicType *basicType);
     /// Construction helper to process DICompositeTypes.
@@ -394,11 +416,12 @@ private:
     /// Attaches the typedef(s) to the base node.
     void handleTypedef(const DIType *typedefType);
 
-    /// Populates fieldTypes for type and all its elements.
-    void flatten(const DICompositeType *type);
+    /// Populates fieldTypes (classes/structs) and containingAggs (all aggregates)
+    /// for types and all their elements, level by level on -dchg-threads threads.
+    void flattenAndGatherAggs(const std::vector<const DICompositeType *> &types);
 
-    /// Populates containingAggs for type and all its elements.
-    void gatherAggs(const DICompositeType *type);
+    /// Records the AggInfo of type and of the aggregates it is made of, parts before wholes.
+    void collectAggInfo(const DICompositeType *type, AggInfoMap &aggInfos, std::vector<const DIType *> &order);
 
     /// Creates a node from type, or returns it if it exists.
     DCHNode *getOrCreateNode(const DIType *type);
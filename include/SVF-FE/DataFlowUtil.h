@@ -139,6 +139,10 @@ public:
      /// Get dominator tree of a function
      DominatorTree* getDT(const Function* f);
 
+     /// Compute dominator trees, post dominator trees and loop info of functions up front,
+     /// functions are analysed concurrently on numOfThreads threads
+     void buildCFInfo(const std::vector<const Function*>& funs, u32_t numOfThreads);
+
 private:
     FunToLoopInfoMap funToLoopInfoMap;      ///< map a function to its loop info
     FunToDTMap funToDTMap;                  ///< map a function to its dominator tree
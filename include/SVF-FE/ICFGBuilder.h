@@ -50,6 +50,35 @@ private:
 public:
     typedef FIFOWorkList<const Instruction*> WorkList;
 
+    /// The intra-procedural part of the ICFG of a function, collected by a worker thread
+    /// before any of its nodes exist. Nodes are referred to by their index in nodes,
+    /// or by FunEntryIdx/FunExitIdx for the entry/exit node of the function.
+    struct PendingFunICFG
+    {
+        static const u32_t FunEntryIdx = ~0u;
+        static const u32_t FunExitIdx = ~0u - 1;
+
+        /// An intra-procedural edge, or a conditional one if cond is not null
+        struct Edge
+        {
+            u32_t src;
+            u32_t dst;
+            const Value* cond;
+            NodeID branchID;
+        };
+
+        /// Instruction and kind (IntraBlock, FunCallBlock or FunRetBlock) of the nodes in creation order
+        std::vector<std::pair<const Instruction*, ICFGNode::ICFGNodeK>> nodes;
+        /// Edges in the order they are added (duplicates are dropped when they are added)
+        std::vector<Edge> edges;
+        /// Call sites in the order their call nodes are created
+        InstVec callSites;
+        /// Index of the intra/call node and of the ret node of an instruction
+        Map<const Instruction*, u32_t> blockNodes;
+        Map<const Instruction*, u32_t> retNodes;
+    };
+    typedef std::vector<PendingFunICFG> PendingFunICFGList;
+
     ICFGBuilder(ICFG* i): icfg(i)
     {
 
@@ -57,15 +86,20 @@ public:
     void build(SVFModule* svfModule);
 
 private:
-    /// Create edges between ICFG nodes within a function
-    ///@{
-    void processFunEntry(const SVFFunction*  fun, WorkList& worklist);
-
-    void processFunBody(WorkList& worklist);
-
-    void processFunExit(const SVFFunction*  fun);
+    /// Build the intra-procedural ICFGs of functions on numThreads threads, then add
+    /// the inter-procedural edges serially. Node ids do not depend on numThreads.
+    void buildFunICFGs(const std::vector<const SVFFunction*>& funs, u32_t numThreads);
+
+    /// Collect the intra-procedural nodes and edges of a function without touching the ICFG
+    //@{
+    void collectFunICFG(const SVFFunction* fun, PendingFunICFG& pending) const;
+    u32_t getOrAddPendingBlockNode(const Instruction* inst, PendingFunICFG& pending) const;
+    u32_t getOrAddPendingRetNode(const Instruction* inst, PendingFunICFG& pending) const;
     //@}
 
+    /// Create the nodes (numbered from firstID) and the intra-procedural edges of a collected function
+    void createFunICFG(const SVFFunction* fun, const PendingFunICFG& pending, NodeID firstID, std::vector<ICFGNode*>& nodes) const;
+
     void connectGlobalToProgEntry(SVFModule* svfModule);
 
     /// Add/Get an inter block ICFGNode
@@ -59,6 +59,8 @@ private:
     FunDefToDeclsMapTy FunDefToDeclsMap;
     /// Global definition to a rep definition map
     GlobalDefToRepMapTy GlobalDefToRepMap;
+    /// Functions with local linkage whose unreached bodies were dropped (-lazy-load)
+    Set<const Function*> droppedLocalFuns;
 
     /// Constructor
     LLVMModuleSet(): svfModule(nullptr), cxts(nullptr), preProcessed(false) {}
@@ -78,6 +80,8 @@ public:
         if (llvmModuleSet)
             delete llvmModuleSet;
         llvmModuleSet = nullptr;
+        /// the caches refer to types and functions of the released modules
+        cppUtil::clearCaches();
     }
 
     SVFModule* buildSVFModule(Module &mod);
@@ -232,6 +236,10 @@ public:
 
 private:
     void loadModules(const std::vector<std::string> &moduleNameVec);
+    /// Read the input files into memory, on -load-threads threads
+    void readModuleFiles(const std::vector<std::string> &moduleNameVec, std::vector<std::unique_ptr<MemoryBuffer>> &buffers, std::vector<std::string> &errors);
+    /// Materialize the bodies of lazily loaded functions reachable from main (-lazy-load), drop the others
+    void materializeReachableFunctions();
     void addSVFMain();
     void initialize();
     void buildFunToFunMap();
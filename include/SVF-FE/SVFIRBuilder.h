@@ -44,15 +44,40 @@ class SVFModule;
 class SVFIRBuilder: public llvm::InstVisitor<SVFIRBuilder>
 {
 
+public:
+    /// A statement of a function collected by a worker thread, whose operands are the
+    /// SVFIR nodes pre-allocated from the symbol table. Instructions which may create nodes
+    /// or edges elsewhere (constant expressions, geps, calls, branches) are recorded as
+    /// Visit and handled by the visitor when the buffers are merged.
+    struct PendingStmt
+    {
+        enum Kind
+        {
+            Addr, Copy, Phi, Load, Store, BinaryOP, UnaryOP, Cmp, BlackHoleAddr, Visit
+        };
+        Kind kind;
+        Instruction* inst;
+        NodeID src;
+        NodeID dst;
+        NodeID op2;     ///< second operand of BinaryOP and Cmp
+        u32_t opcode;   ///< opcode of BinaryOP/UnaryOP, predicate of Cmp
+        PendingStmt(Kind k, Instruction* i, NodeID s = 0, NodeID d = 0, NodeID o = 0, u32_t op = 0):
+            kind(k), inst(i), src(s), dst(d), op2(o), opcode(op)
+        {
+        }
+    };
+    typedef std::vector<PendingStmt> PendingStmtList;
+
 private:
     SVFIR* pag;
     SVFModule* svfMod;
     const BasicBlock* curBB;	///< Current basic block during SVFIR construction when visiting the module
     const Value* curVal;	///< Current Value during SVFIR construction when visiting the module
+    PendingStmtList* pendingStmts;	///< If not null, statements are recorded here instead of being added to SVFIR
 
 public:
     /// Constructor
-    SVFIRBuilder(): pag(SVFIR::getPAG()), svfMod(nullptr), curBB(nullptr),curVal(nullptr)
+    SVFIRBuilder(): pag(SVFIR::getPAG()), svfMod(nullptr), curBB(nullptr),curVal(nullptr),pendingStmts(nullptr)
     {
     }
     /// Destructor
@@ -79,6 +104,23 @@ public:
     /// Sanity check for SVFIR
     void sanityCheck();
 
+    /// Handle functions, collecting their statements on -pag-build-threads threads
+    //@{
+    void visitFunctions(SVFModule* svfModule);
+    void initialiseFunRetAndArgs(const SVFFunction& fun);
+    void collectPendingStmts(const SVFFunction& fun, PendingStmtList& stmts) const;
+    void mergePendingStmts(const PendingStmtList& stmts);
+    /// Record a statement of the current instruction if collecting (see collectPendingStmts)
+    inline bool deferStmt(PendingStmt::Kind kind, NodeID src, NodeID dst, NodeID op2 = 0, u32_t opcode = 0)
+    {
+        if (pendingStmts == nullptr)
+            return false;
+        Instruction* inst = const_cast<Instruction*>(SVFUtil::cast<Instruction>(curVal));
+        pendingStmts->push_back(PendingStmt(kind, inst, src, dst, op2, opcode));
+        return true;
+    }
+    //@}
+
     /// Get different kinds of node
     //@{
     // GetValNode - Return the value node according to a LLVM Value.
@@ -275,6 +317,8 @@ public:
 
     inline PAGEdge* addBlackHoleAddrEdge(NodeID node)
     {
+        if (deferStmt(PendingStmt::BlackHoleAddr, 0, node))
+            return nullptr;
         PAGEdge *edge = pag->addBlackHoleAddrStmt(node);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -283,6 +327,8 @@ public:
     /// Add Address edge
     inline AddrStmt* addAddrEdge(NodeID src, NodeID dst)
     {
+        if (deferStmt(PendingStmt::Addr, src, dst))
+            return nullptr;
         AddrStmt *edge = pag->addAddrStmt(src, dst);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -290,6 +336,8 @@ public:
     /// Add Copy edge
     inline CopyStmt* addCopyEdge(NodeID src, NodeID dst)
     {
+        if (deferStmt(PendingStmt::Copy, src, dst))
+            return nullptr;
         CopyStmt *edge = pag->addCopyStmt(src, dst);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -297,6 +345,8 @@ public:
     /// Add Copy edge
     inline PhiStmt* addPhiStmt(NodeID res, NodeID opnd)
     {
+        if (deferStmt(PendingStmt::Phi, opnd, res))
+            return nullptr;
         PhiStmt *edge = pag->addPhiStmt(res,opnd);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -304,6 +354,8 @@ public:
     /// Add Copy edge
     inline CmpStmt* addCmpEdge(NodeID op1, NodeID op2, NodeID dst, u32_t predict)
     {
+        if (deferStmt(PendingStmt::Cmp, op1, dst, op2, predict))
+            return nullptr;
         CmpStmt *edge = pag->addCmpStmt(op1, op2, dst, predict);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -311,6 +363,8 @@ public:
     /// Add Copy edge
     inline BinaryOPStmt* addBinaryOPEdge(NodeID op1, NodeID op2, NodeID dst, u32_t opcode)
     {
+        if (deferStmt(PendingStmt::BinaryOP, op1, dst, op2, opcode))
+            return nullptr;
         BinaryOPStmt *edge = pag->addBinaryOPStmt(op1, op2, dst, opcode);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -318,6 +372,8 @@ public:
     /// Add Unary edge
     inline UnaryOPStmt* addUnaryOPEdge(NodeID src, NodeID dst, u32_t opcode)
     {
+        if (deferStmt(PendingStmt::UnaryOP, src, dst, 0, opcode))
+            return nullptr;
         UnaryOPStmt *edge = pag->addUnaryOPStmt(src, dst, opcode);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -331,6 +387,8 @@ public:
     /// Add Load edge
     inline LoadStmt* addLoadEdge(NodeID src, NodeID dst)
     {
+        if (deferStmt(PendingStmt::Load, src, dst))
+            return nullptr;
         LoadStmt *edge = pag->addLoadStmt(src, dst);
         setCurrentBBAndValueForPAGEdge(edge);
         return edge;
@@ -338,6 +396,8 @@ public:
     /// Add Store edge
     inline StoreStmt* addStoreEdge(NodeID src, NodeID dst)
     {
+        if (deferStmt(PendingStmt::Store, src, dst))
+            return nullptr;
         IntraBlockNode* node;
         if(const Instruction* inst = SVFUtil::dyn_cast<Instruction>(curVal))
             node = pag->getICFG()->getIntraBlockNode(inst);
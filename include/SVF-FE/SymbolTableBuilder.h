@@ -50,9 +50,25 @@ public:
     SymbolTableBuilder(SymbolTableInfo* si): symInfo(si){
     }
 
+    /// Symbols of a function, in the order they are met when visiting the function
+    struct FunSyms
+    {
+        std::vector<const Value*> syms;
+        std::vector<CallSite> callSites;
+    };
+
     /// Start building memory model
     void buildMemModel(SVFModule* svfModule);
 
+    /// Collect the symbols of a function (thread safe), and create them
+    //@{
+    void collectFunSyms(const Function* fun, FunSyms& funSyms) const;
+    void createFunSyms(Function* fun, const FunSyms& funSyms);
+    //@}
+
+    /// Collect the field info of all struct types on multiple threads
+    void collectStructTypeInfo(u32_t numThreads);
+
     /// collect the syms
     //@{
     void collectSym(const Value *val);
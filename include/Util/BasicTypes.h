@@ -72,6 +72,7 @@ class BddCond;
 /// LLVM Basic classes
 typedef llvm::SMDiagnostic SMDiagnostic;
 typedef llvm::LLVMContext LLVMContext;
+typedef llvm::MemoryBuffer MemoryBuffer;
 typedef llvm::Type Type;
 typedef llvm::Function Function;
 typedef llvm::BasicBlock BasicBlock;
@@ -232,18 +233,23 @@ namespace dwarf = llvm::dwarf;
 
 class SVFFunction : public SVFValue
 {
+public:
+    /// extType of a function whose ExtAPI::extf_t has not been resolved
+    static const u32_t UnresolvedExtType = ~0u;
+
 private:
     bool isDecl;
     bool isIntri;
     Function* fun;
+    u32_t extType;  ///< ExtAPI::extf_t of this function, resolved once when it is added to the SVFModule
 public:
     SVFFunction(const std::string& val): SVFValue(val,SVFValue::SVFFunc),
-        isDecl(false), isIntri(false), fun(nullptr)
+        isDecl(false), isIntri(false), fun(nullptr), extType(UnresolvedExtType)
     {
     }
 
     SVFFunction(Function* f): SVFValue(f->getName(),SVFValue::SVFFunc),
-        isDecl(f->isDeclaration()), isIntri(f->isIntrinsic()), fun(f)
+        isDecl(f->isDeclaration()), isIntri(f->isIntrinsic()), fun(f), extType(UnresolvedExtType)
     {
     }
     inline Function* getLLVMFun() const
@@ -262,6 +268,18 @@ public:
         return isIntri;
     }
 
+    /// Get/set the ExtAPI::extf_t of this function (see ExtAPI::resolve_type)
+    //@{
+    inline u32_t getExtType() const
+    {
+        return extType;
+    }
+    inline void setExtType(u32_t t)
+    {
+        extType = t;
+    }
+    //@}
+
     inline u32_t arg_size() const
     {
         return getLLVMFun()->arg_size();
@@ -32,6 +32,7 @@
 
 #include "Util/BasicTypes.h"
 #include <cstdio>
+#include <atomic>
 
 #include "CUDD/cuddInt.h"
 #include "z3++.h"
@@ -116,10 +117,7 @@ class BranchCondManager
 public:
     typedef BranchCondExpr::BranchCond BranchCond;
     /// Constructor
-    BranchCondManager()
-    {
-        m_bdd_mgr = Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, 0);
-    }
+    BranchCondManager();
 
     /// Destructor
     ~BranchCondManager()
@@ -148,6 +146,21 @@ public:
     {
         return Cudd_ReadNodeCount(m_bdd_mgr);
     }
+    /// Peak number of live BDD nodes
+    inline u32_t getPeakNodeNumber() const
+    {
+        return std::max(m_bdd_mgr->peakLiveNodes, m_bdd_mgr->keys - m_bdd_mgr->dead);
+    }
+    /// Number of dynamic variable reorderings
+    inline u32_t getReorderNumber() const
+    {
+        return m_bdd_mgr->reorderings;
+    }
+    /// Time (ms) spent in dynamic variable reordering
+    inline u64_t getReorderTime() const
+    {
+        return m_bdd_mgr->reordTime;
+    }
     /// Operations on conditions.
     //@{
     BranchCond* AND(BranchCond* lhs, BranchCond* rhs);
@@ -166,6 +179,9 @@ public:
     std::string dumpStr(BranchCond* lhs) const;
 
 private:
+    /// Set up dynamic variable reordering, garbage collection and table growth according to user options
+    void initReorderAndGC();
+
     inline BranchCond* BddOne() const
     {
         return Cudd_ReadOne(m_bdd_mgr);
@@ -189,23 +205,31 @@ private:
 public:
     typedef BranchCondExpr::BranchCond BranchCond;
     typedef Map<const CondExpr*, const Instruction* > CondToTermInstMap;	// map a condition to its branch instruction
-    static u32_t totalCondNum; // a counter for fresh condition
-    /// Singleton design here to make sure we only have one instance during any analysis
+    /// A counter for fresh condition, shared by all managers so that the i-th
+    /// condition variable denotes the same branch in every (per-thread) manager
+    static std::atomic<u32_t> totalCondNum;
+    /// Singleton design here to make sure we only have one instance during any analysis,
+    /// unless a manager is bound to the current thread (see setThreadCondMgr)
     //@{
-    static inline CondManager* getCondMgr()
-    {
-        if (condMgr == nullptr)
-        {
-            condMgr = new CondManager();
-        }
-        return condMgr;
-    }
-    static void releaseCondMgr()
+    static CondManager* getCondMgr();
+    static void releaseCondMgr();
+    //@}
+
+    /// Per-thread managers (e.g., of -path-cond-threads). The caller creates and owns one
+    /// manager per worker, binds it on the worker so that getCondMgr() returns it there,
+    /// and deletes it only after the worker's conditions have been translated (see translate)
+    /// into the global manager, i.e., after the worker has been joined.
+    //@{
+    static CondManager* createThreadCondMgr();
+    static void setThreadCondMgr(CondManager* mgr);
+    //@}
+
+    /// Reserve num consecutive condition variables and return the index of the first one,
+    /// so that their conditions can be created in any manager (see getOrAddFreshBranchCond)
+    static inline u32_t reserveFreshBranchConds(u32_t num)
     {
-        delete condMgr;
-        condMgr = nullptr;
+        return totalCondNum.fetch_add(num);
     }
-    //@}
 
     typedef Map<u32_t, CondExpr*> IDToCondExprMap;
     typedef Map<BranchCond*, CondExpr*> BranchCondToCondExprMap;
@@ -216,9 +240,16 @@ public:
     /// Create a fresh condition to encode each program branch
     CondExpr* createFreshBranchCond(const Instruction* inst);
 
+    /// Get or add the branch condition of the condIdx-th condition variable
+    CondExpr* getOrAddFreshBranchCond(u32_t condIdx, const Instruction* inst);
+
     /// Get or add a single branch condition, e.g., when doing condition conjunction
     CondExpr* getOrAddBranchCond(const z3::expr& e, BranchCond* branchCond);
 
+    /// Translate a condition allocated by another manager (e.g., of a worker thread) into this manager,
+    /// e.g., when merging the results of a per-thread analysis
+    CondExpr* translate(const CondExpr* cond, const CondManager* srcMgr);
+
     /// Return the number of condition expressions
     u32_t getCondNumber();
 
@@ -245,6 +276,22 @@ public:
     /// Return memory usage for this condition manager
     std::string getMemUsage();
 
+    /// Statistics of the BDD manager
+    //@{
+    inline u32_t getBddPeakNodeNum() const
+    {
+        return branchCondManager.getPeakNodeNumber();
+    }
+    inline u32_t getBddReorderNum() const
+    {
+        return branchCondManager.getReorderNumber();
+    }
+    inline u64_t getBddReorderTime() const
+    {
+        return branchCondManager.getReorderTime();
+    }
+    //@}
+
     /// Dump out all expressions
     void printModel();
 
@@ -260,6 +307,22 @@ public:
     /// Whether the condition is satisfiable
     bool isSatisfiable(const CondExpr* cond);
 
+    /// Statistics of satisfiability checking
+    //@{
+    inline u32_t getSatCacheHitNum() const
+    {
+        return satCacheHits;
+    }
+    inline u32_t getSatCacheMissNum() const
+    {
+        return satCacheMisses;
+    }
+    inline double getSolverTime() const
+    {
+        return solverTime;
+    }
+    //@}
+
     /// Whether lhs and rhs are equivalent branch conditions
     inline bool isEquivalentBranchCond(const CondExpr* lhs, const CondExpr* rhs) const{
         return SVFUtil::dyn_cast<BranchCondExpr>(lhs)->getBranchCond() ==
@@ -299,15 +362,26 @@ public:
     //@}
 
 private:
+    /// Translate a condition from srcMgr, sharing the translation of common sub-conditions
+    CondExpr* translate(const CondExpr* cond, const CondManager* srcMgr, Map<const CondExpr*, CondExpr*>& translated);
+
+    /// Collect the conjuncts of a condition in order, e.g., (c1 ^ c2) ^ c3 gives [c1, c2, c3]
+    void collectConjuncts(const z3::expr& e, std::vector<z3::expr>& conjuncts) const;
+
     z3::context cxt;
     z3::solver sol;
-    static CondExpr* trueCond;
-    static CondExpr* falseCond;
+    CondExpr* trueCond;
+    CondExpr* falseCond;
     IDToCondExprMap allocatedConds; ///< map condition id (z3 ast id) to its Condition wrapper
     BranchCondToCondExprMap branchCondToCondExpr; ///< map branch condition to its Condition wrapper
     CondToTermInstMap condToInstMap; ///< map condition to llvm instruction
     BranchCondManager branchCondManager; ///< branch condition manager
     NodeBS negConds;
+    Map<u32_t, bool> satCache; ///< map condition id (z3 ast id) to its memoised satisfiability
+    std::vector<u32_t> assertedConjuncts; ///< ids of the conjuncts asserted on the solver, one scope per conjunct
+    u32_t satCacheHits;
+    u32_t satCacheMisses;
+    double solverTime;
 };
 
 } // End namespace SVF
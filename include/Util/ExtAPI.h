@@ -91,23 +91,38 @@ public:
     };
 private:
 
-    //Each Function name is mapped to its extf_t
-    //  (hash_map and map are much slower).
-    llvm::StringMap<extf_t> info;
-    //A cache of is_ext results for all SVFFunction*'s (hash_map is fastest).
-    Map<const SVFFunction*, bool> isext_cache;
+    //Functions summarised in -ext-api-spec, mapped to their extf_t
+    //  (checked before the built-in database).
+    llvm::StringMap<extf_t> spec_types;
 
-    void init();                          //fill in the map (see ExtAPI.cpp)
+    void init();                          //check the database and load -ext-api-spec (see ExtAPI.cpp)
+
+    //Size of the text of a spec file and its hash
+    struct SpecStamp
+    {
+        u64_t size;
+        u64_t hash;
+    };
+    //Fill in spec_types from the spec file, through its binary cache (if any) if it is up to date.
+    void load_spec(const std::string& specFile, const std::string& cacheFile);
+    //Parse the text of a spec file into spec_types.
+    void parse_spec(llvm::StringRef text, const std::string& specFile);
+    //Read spec_types from the binary cache of a spec file with (stamp), matched by size and
+    //  hash; write spec_types to the cache.
+    bool read_spec_cache(const std::string& cacheFile, const SpecStamp& stamp);
+    void write_spec_cache(const std::string& cacheFile, const SpecStamp& stamp) const;
 
     ExtAPI()
     {
         init();
-        isext_cache.clear();
     }
 
     // Singleton pattern here to enable instance of SVFIR can only be created once.
     static ExtAPI* extAPI;
 
+    //Look up the extf_t of (F) in the database (see ExtAPI.cpp).
+    extf_t find_type(const SVFFunction* F) const;
+
 public:
 
     /// Singleton design here to make sure we only have one instance during whole analysis
@@ -129,20 +144,32 @@ public:
         }
     }
 
+    //Look up the extf_t of (F) once and store it on (F), so that get_type
+    //  does not look up the name again (done when F is added to the SVFModule).
+    void resolve_type(SVFFunction* F) const
+    {
+        assert(F);
+        F->setExtType(find_type(F));
+    }
+
     //Return the extf_t of (F).
     extf_t get_type(const SVFFunction* F) const
     {
         assert(F);
-        std::string funName = F->getName().str();
-        if(F->isIntrinsic())
-        {
-            funName = "llvm." + F->getName().split('.').second.split('.').first.str();
-        }
-        llvm::StringMap<extf_t>::const_iterator it= info.find(funName);
-        if(it == info.end() || !F->isDeclaration())
+        if(F->getExtType() != SVFFunction::UnresolvedExtType)
+            return static_cast<extf_t>(F->getExtType());
+        return find_type(F);
+    }
+
+    //Return the extf_t of (F) given by -ext-api-spec, EFT_OTHER if it is not summarised there.
+    //  As with the built-in summaries, only declarations are summarised.
+    extf_t get_spec_type(const SVFFunction* F) const
+    {
+        assert(F);
+        if(!F->isDeclaration())
             return EFT_OTHER;
-        else
-            return it->second;
+        llvm::StringMap<extf_t>::const_iterator it= spec_types.find(F->getName());
+        return it == spec_types.end() ? EFT_OTHER : it->second;
     }
 
     //Does (F) have a static var X (unavailable to us) that its return points to?
@@ -214,27 +241,15 @@ public:
     }
     //Should (F) be considered "external" (either not defined in the program
     //  or a user-defined version of a known alloc or no-op)?
-    bool is_ext(const SVFFunction* F)
+    bool is_ext(const SVFFunction* F) const
     {
         assert(F);
-        //Check the cache first; everything below is slower.
-        Map<const SVFFunction*, bool>::iterator i_iec= isext_cache.find(F);
-        if(i_iec != isext_cache.end())
-            return i_iec->second;
-
-        bool res;
         if(F->isDeclaration() || F->isIntrinsic())
-        {
-            res= 1;
-        }
-        else
-        {
-            extf_t t= get_type(F);
-            res= t==EFT_ALLOC || t==EFT_REALLOC || t==EFT_NOSTRUCT_ALLOC
-                 || t==EFT_NOOP || t==EFT_FREE;
-        }
-        isext_cache[F]= res;
-        return res;
+            return true;
+
+        extf_t t= get_type(F);
+        return t==EFT_ALLOC || t==EFT_REALLOC || t==EFT_NOSTRUCT_ALLOC
+               || t==EFT_NOOP || t==EFT_FREE;
     }
 };
 
@@ -0,0 +1,177 @@
+//===- FlatIndexMap.h -- Open addressing map with insertion order----------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * FlatIndexMap.h
+ *
+ * Map from pointers or ids to small values, used by the symbol table whose
+ * entries are looked up for every operand when building SVFIR.
+ */
+
+#ifndef FLATINDEXMAP_H_
+#define FLATINDEXMAP_H_
+
+#include "Util/SVFBasicTypes.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace SVF
+{
+
+/*!
+ * Map whose entries are kept in a vector in the order they are inserted, and are
+ * found through an open addressing (linear probing) table of indices into the vector.
+ *
+ * Iteration follows the insertion order, hence is deterministic (unlike iterating
+ * a std::map keyed by pointers). Entries cannot be erased, and inserting may
+ * invalidate iterators. Concurrent lookups are safe as long as nothing is inserted.
+ */
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class FlatIndexMap
+{
+public:
+    typedef std::pair<Key, Value> value_type;
+    typedef std::vector<value_type> EntryVector;
+    typedef typename EntryVector::iterator iterator;
+    typedef typename EntryVector::const_iterator const_iterator;
+
+    FlatIndexMap() : mask(0)
+    {
+    }
+
+    /// Iterators over the entries in insertion order
+    //@{
+    inline iterator begin()
+    {
+        return entries.begin();
+    }
+    inline iterator end()
+    {
+        return entries.end();
+    }
+    inline const_iterator begin() const
+    {
+        return entries.begin();
+    }
+    inline const_iterator end() const
+    {
+        return entries.end();
+    }
+    //@}
+
+    inline size_t size() const
+    {
+        return entries.size();
+    }
+    inline bool empty() const
+    {
+        return entries.empty();
+    }
+
+    /// Find the entry of a key, end() if there is none
+    //@{
+    inline iterator find(const Key& key)
+    {
+        u32_t idx = lookup(key);
+        return idx == EmptySlot ? entries.end() : entries.begin() + idx;
+    }
+    inline const_iterator find(const Key& key) const
+    {
+        u32_t idx = lookup(key);
+        return idx == EmptySlot ? entries.end() : entries.begin() + idx;
+    }
+    inline size_t count(const Key& key) const
+    {
+        return lookup(key) == EmptySlot ? 0 : 1;
+    }
+    //@}
+
+    /// Insert an entry if its key is not in the map
+    std::pair<iterator, bool> insert(const value_type& entry)
+    {
+        if ((entries.size() + 1) * 2 > slots.size())
+            grow();
+
+        u32_t slot = getSlot(entry.first);
+        if (slots[slot] != EmptySlot)
+            return std::make_pair(entries.begin() + slots[slot], false);
+
+        slots[slot] = entries.size();
+        entries.push_back(entry);
+        return std::make_pair(entries.end() - 1, true);
+    }
+
+    inline Value& operator[](const Key& key)
+    {
+        return insert(std::make_pair(key, Value())).first->second;
+    }
+
+    void clear()
+    {
+        entries.clear();
+        slots.clear();
+        mask = 0;
+    }
+
+private:
+    static const u32_t EmptySlot = ~0u;
+
+    /// Slot holding the key, or the empty slot where it would be inserted
+    inline u32_t getSlot(const Key& key) const
+    {
+        // Fibonacci hashing spreads the (often aligned) pointers and consecutive ids
+        u32_t slot = static_cast<u32_t>((static_cast<u64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+        while (slots[slot] != EmptySlot && !(entries[slots[slot]].first == key))
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    inline u32_t lookup(const Key& key) const
+    {
+        if (slots.empty())
+            return EmptySlot;
+        return slots[getSlot(key)];
+    }
+
+    /// Double the table (keeping it at most half full) and re-insert all the entries
+    void grow()
+    {
+        size_t capacity = slots.empty() ? 16 : slots.size() * 2;
+        slots.assign(capacity, EmptySlot);
+        mask = capacity - 1;
+        for (u32_t i = 0; i < entries.size(); ++i)
+            slots[getSlot(entries[i].first)] = i;
+    }
+
+    EntryVector entries;        ///< entries in insertion order
+    std::vector<u32_t> slots;   ///< open addressing table of indices into entries
+    u32_t mask;                 ///< size of slots - 1, the size being a power of two
+};
+
+template<typename Key, typename Value, typename Hash>
+const u32_t FlatIndexMap<Key, Value, Hash>::EmptySlot;
+
+} // End namespace SVF
+
+#endif /* FLATINDEXMAP_H_ */
@@ -7,6 +7,8 @@
 #include "Util/SVFBasicTypes.h"
 #include "MemoryModel/PointsTo.h"
 
+#include <atomic>
+
 namespace SVF
 {
 
@@ -125,8 +127,19 @@ public:
         static const std::string LargestRegion;
         static const std::string BestCandidate;
         static const std::string NumNonTrivialRegionObjects;
+        static const std::string NumSparseRegions;
+        ///@}
+
+    public:
+        /// Statistics strings of online re-clustering.
+        ///@{
+        static const std::string RemapOldWords;
+        static const std::string RemapSavedBits;
         ///@}
 
+        /// Titled statistics in the order they are to be printed.
+        typedef std::vector<std::pair<std::string, Map<std::string, std::string>>> StatsList;
+
     public:
         /// Returns vector mapping previously allocated node IDs to a smarter allocation
         /// based on the points-to sets in pta accessed through keys.
@@ -136,6 +149,18 @@ public:
         /// TODO: kind of sucks pta can't be const here because getPts isn't.
         static std::vector<NodeID> cluster(BVDataPTAImpl *pta, const std::vector<std::pair<NodeID, unsigned>> keys, std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> &candidates, std::string evalSubtitle="");
 
+        /// As above, but from points-to sets and their number of occurrences directly. Does not
+        /// touch any analysis so it can run on a snapshot of the points-to sets in another thread.
+        /// If deferredStats is given, statistics are appended to it instead of being printed, so that
+        /// such a thread does not interleave its output with the main thread's.
+        /// If cancelled is given and becomes set, the remaining regions are skipped and an empty
+        /// mapping is returned.
+        static std::vector<NodeID> cluster(const Map<PointsTo, unsigned> &pointsToSets, std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> &candidates, std::string evalSubtitle="", StatsList *deferredStats=nullptr, const std::atomic<bool> *cancelled=nullptr);
+
+        /// Returns the number of words the points-to sets in stats (as filled by evaluate) need with the
+        /// new mapping for the current points-to set type.
+        static u64_t getNewNumWords(Map<std::string, std::string> &stats);
+
         // Returns a reverse node mapping for mapping generated by cluster().
         static std::vector<NodeID> getReverseNodeMapping(const std::vector<NodeID> &nodeMapping);
 
@@ -159,10 +184,22 @@ public:
 
         /// Builds the upper triangle of the distance matrix, as an array of length
         /// (numObjects * (numObjects - 1)) / 2, as required by fastcluster.
+        /// Rows are split amongst numThreads threads.
         /// Responsibility of caller to `delete`.
-        static inline double *getDistanceMatrix(const std::vector<std::pair<const PointsTo *, unsigned>> pointsToSets,
+        static inline double *getDistanceMatrix(const std::vector<std::pair<const PointsTo *, unsigned>> &pointsToSets,
                                                 const size_t numObjects, const Map<NodeID, unsigned> &nodeMap,
-                                                double &distanceMatrixTime);
+                                                double &distanceMatrixTime, unsigned numThreads);
+
+        /// Updates the distance between two objects given a points-to set of distance containing both,
+        /// which occurs occ times.
+        static inline void updateDistance(double &existingDistance, const unsigned distance, const unsigned occ);
+
+        /// For regions too large for a distance matrix: single linkage over the sparse distances
+        /// between objects sharing a points-to set, with the same spanning tree and dendrogram as
+        /// fastcluster would build from the matrix. Returns, for each object of the region (per
+        /// nodeMap), its position in the order of the leaves of the resulting dendrogram.
+        static inline std::vector<NodeID> getSparseSingleLinkageOrder(const std::vector<std::pair<const PointsTo *, unsigned>> &pointsToSets,
+                                                                      const size_t numObjects, const Map<NodeID, unsigned> &nodeMap);
 
         /// Traverses the dendrogram produced by fastcluster, making node o, where o is the nth leaf (per
         /// recursive DFS) map to n. index is the dendrogram node to work off. The traversal should start
@@ -178,7 +215,10 @@ public:
         // From all the candidates, returns the best mapping for pointsToSets (points-to set -> # occurences).
         static inline std::pair<hclust_fast_methods, std::vector<NodeID>> determineBestMapping(
             const std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> &candidates,
-            Map<PointsTo, unsigned> pointsToSets, const std::string &evalSubtitle, double &evalTime);
+            Map<PointsTo, unsigned> pointsToSets, const std::string &evalSubtitle, double &evalTime, StatsList *deferredStats);
+
+        /// Prints stats, or appends them to deferredStats if not null.
+        static inline void printOrDeferStats(const std::string &subtitle, Map<std::string, std::string> &stats, StatsList *deferredStats);
 
     };
 };
@@ -42,6 +42,10 @@ public:
     /// Whether to cluster FS or VFS with the auxiliary Andersen's.
     static const llvm::cl::opt<bool> ClusterFs;
 
+    /// Re-cluster FS or VFS every given number of processed nodes from the points-to
+    /// sets computed so far (0 to never re-cluster).
+    static const llvm::cl::opt<unsigned> ClusterFsOnline;
+
     /// Use an explicitly plain mapping with flow-sensitive (not null).
     static const llvm::cl::opt<bool> PlainMappingFs;
 
@@ -64,6 +68,13 @@ public:
     /// weigh more common points-to sets as more important.
     static const llvm::cl::opt<bool> PredictPtOcc;
 
+    /// Number of threads clustering regions and evaluating candidate methods.
+    static const llvm::cl::opt<unsigned> ClusterThreads;
+
+    /// Regions with more objects are clustered through sparse single linkage rather
+    /// than with a distance matrix (0 for no limit).
+    static const llvm::cl::opt<unsigned> ClusterMaxMatrixObjects;
+
     /// PTData type.
     static const llvm::cl::opt<BVDataPTAImpl::PTBackingType> ptDataBacking;
 
@@ -163,6 +174,7 @@ public:
     static const llvm::cl::opt<bool> IntraLock;
     static const llvm::cl::opt<bool> ReadPrecisionTDEdge;
     static const llvm::cl::opt<u32_t> AddModelFlag;
+    static const llvm::cl::opt<unsigned> TDEdgeThreads;
 
     // LockAnalysis.cpp
     static const llvm::cl::opt<bool> PrintLockSpan;
@@ -170,6 +182,9 @@ public:
     // MHP.cpp
     static const llvm::cl::opt<bool> PrintInterLev;
     static const llvm::cl::opt<bool> DoLockAnalysis;
+    static const llvm::cl::opt<unsigned> MHPThreads;
+    static const llvm::cl::opt<bool> MHPQueryClasses;
+    static const llvm::cl::opt<bool> MHPPCGPrefilter;
 
     // MTA.cpp
     static const llvm::cl::opt<bool> AndersenAnno;
@@ -185,11 +200,17 @@ public:
     //MTAStat.cpp
     static const llvm::cl::opt<bool> AllPairMHP;
 
+    // MTAReportSink.cpp
+    static const llvm::cl::opt<std::string> MTAReportFile;
+    static const llvm::cl::opt<unsigned> MTAReportFlushMs;
+    static const llvm::cl::opt<unsigned> MTAReportBufferSize;
+
     // PCG.cpp
     //const llvm::cl::opt<bool> TDPrint
 
     // TCT.cpp
     static const llvm::cl::opt<bool> TCTDotGraph;
+    static const llvm::cl::opt<unsigned> TCTThreads;
 
     // LeakChecker.cpp
     static const llvm::cl::opt<bool> ValidateTests;
@@ -203,25 +224,50 @@ public:
 
     // DCHG.cpp
     static const llvm::cl::opt<bool> PrintDCHG;
+    static const llvm::cl::opt<unsigned> DCHGThreads;
 
     // LLVMModule.cpp
     static const llvm::cl::opt<std::string> Graphtxt;
     static const llvm::cl::opt<bool> SVFMain;
+    static const llvm::cl::opt<unsigned> LoadThreads;
+    static const llvm::cl::opt<bool> LazyLoad;
+
+    // ICFGBuilder.cpp
+    static const llvm::cl::opt<unsigned> ICFGBuildThreads;
+
+    // SVFIRBuilder.cpp
+    static const llvm::cl::opt<unsigned> PAGBuildThreads;
 
     // SymbolTableInfo.cpp
     static const llvm::cl::opt<bool> LocMemModel;
     static const llvm::cl::opt<bool> ModelConsts;
     static const llvm::cl::opt<bool> SymTabPrint;
+    static const llvm::cl::opt<unsigned> SymTabThreads;
 
     // Conditions.cpp
     static const llvm::cl::opt<unsigned> MaxBddSize;
+    static const llvm::cl::opt<bool> IncrementalSat;
+    static const llvm::cl::opt<std::string> BddReorder;
+    static const llvm::cl::opt<unsigned> BddReorderThreshold;
+    static const llvm::cl::opt<bool> BddGC;
+    static const llvm::cl::opt<unsigned> BddMaxMem;
+    static const llvm::cl::opt<unsigned> BddGCFrac;
+    static const llvm::cl::opt<unsigned> BddMinHit;
+    static const llvm::cl::opt<unsigned> BddLooseUpTo;
 
     // PathCondAllocator.cpp
     static const llvm::cl::opt<bool> PrintPathCond;
+    static const llvm::cl::opt<std::string> BddVarOrder;
+    static const llvm::cl::opt<bool> LazyPathCond;
+    static const llvm::cl::opt<unsigned> PathCondThreads;
 
     // SVFUtil.cpp
     static const llvm::cl::opt<bool> DisableWarn;
 
+    // ExtAPI.cpp
+    static const llvm::cl::opt<std::string> ExtAPISpec;
+    static const llvm::cl::opt<std::string> ExtAPISpecCache;
+
     // Andersen.cpp
     static const llvm::cl::opt<bool> ConsCGDotGraph;
     static const llvm::cl::opt<bool> BriefConsCGDotGraph;
@@ -231,10 +277,12 @@ public:
     // static const llvm::cl::opt<string> ReadAnder;
     static const llvm::cl::opt<std :: string> ReadAnder;
     static const llvm::cl::opt<bool> PtsDiff;
+    static const llvm::cl::opt<bool> AnderOVS;
     static const llvm::cl::opt<bool> MergePWC;
 
     // FlowSensitive.cpp
     static const llvm::cl::opt<bool> CTirAliasEval;
+    static const llvm::cl::opt<bool> FsCollapseCopySCC;
 
     //FlowSensitiveTBHC.cpp
     static const llvm::cl::opt<bool> TBHCStoreReuse;
@@ -104,6 +104,7 @@ public:
     inline void addFunctionSet(Function* fun)
     {
         SVFFunction* svfFunc = new SVFFunction(fun);
+        ExtAPI::getExtAPI()->resolve_type(svfFunc);
         FunctionSet.push_back(svfFunc);
         LLVMFunctionSet.push_back(fun);
         LLVMFunc2SVFFunc[fun] = svfFunc;
@@ -127,6 +127,8 @@ public:
     static Size_t numOfSfrs;
     static Size_t numOfFieldExpand;
 
+    static Size_t numOfSubstitutedNodes;
+
     static Size_t numOfSCCDetection;
     static double timeOfSCCDetection;
     static double timeOfSCCMerges;
@@ -259,6 +261,11 @@ public:
 protected:
 
     CallSite2DummyValPN callsite2DummyValPN;        ///< Map an instruction to a dummy obj which created at an indirect callsite, which invokes a heap allocator
+
+    /// Merge pointer-equivalent constraint nodes found by offline variable substitution (-ander-ovs)
+    /// before solving. The merged nodes stay in the rep/subs maps of the constraint graph, so
+    /// sccRepNode keeps answering for them after the analysis.
+    void substituteOfflineEquivalence();
     void heapAllocatorViaIndCall(CallSite cs,NodePairSet &cpySrcNodes);
 
     bool pwcOpt;
@@ -35,6 +35,9 @@
 #include "MemoryModel/PointerAnalysisImpl.h"
 #include "MSSA/SVFGBuilder.h"
 #include "WPA/WPAFSSolver.h"
+#include <atomic>
+#include <future>
+#include <thread>
 
 namespace SVF
 {
@@ -51,6 +54,7 @@ class FlowSensitive : public WPASVFGFSSolver, public BVDataPTAImpl
     friend class FlowSensitiveStat;
 protected:
     typedef SVFG::SVFGEdgeSetTy SVFGEdgeSetTy;
+    typedef Map<NodeID, NodeID> NodeToNodeMap;
 
 public:
     typedef BVDataPTAImpl::MutDFPTDataTy MutDFPTDataTy;
@@ -70,11 +74,14 @@ public:
         numOfProcessedMSSANode = 0;
         maxSCCSize = numOfSCC = numOfNodesInSCC = 0;
         iterationForPrintStat = OnTheFlyIterBudgetForStat;
+        numOfProcessedSinceRecluster = numOfOnlineRemaps = 0;
+        onlineClusterCancelled.store(false);
     }
 
     /// Destructor
     virtual ~FlowSensitive()
     {
+        cancelOnlineCluster();
         if (svfg != nullptr)
             delete svfg;
         svfg = nullptr;
@@ -138,6 +145,34 @@ public:
         return svfg;
     }
 
+    /// Points-to sets of top-level variables merged by collapseTopLevelCopySCCs are kept at
+    /// their representative (as Andersen's does with its SCC reps)
+    //@{
+    inline NodeID topLevelRepNode(NodeID id) const
+    {
+        if (topLevelRep.empty())
+            return id;
+        NodeToNodeMap::const_iterator it = topLevelRep.find(id);
+        return it == topLevelRep.end() ? id : it->second;
+    }
+    virtual inline const PointsTo& getPts(NodeID id) override
+    {
+        return BVDataPTAImpl::getPts(topLevelRepNode(id));
+    }
+    virtual inline bool unionPts(NodeID id, const PointsTo& target) override
+    {
+        return BVDataPTAImpl::unionPts(topLevelRepNode(id), target);
+    }
+    virtual inline bool unionPts(NodeID id, NodeID ptd) override
+    {
+        return BVDataPTAImpl::unionPts(topLevelRepNode(id), topLevelRepNode(ptd));
+    }
+    virtual inline bool addPts(NodeID id, NodeID ptd) override
+    {
+        return BVDataPTAImpl::addPts(topLevelRepNode(id), ptd);
+    }
+    //@}
+
 protected:
     /// SCC detection
     virtual NodeStack& SCCDetect();
@@ -206,7 +241,7 @@ protected:
     }
     virtual inline bool unionPtsFromTop(const SVFGNode* stmt, NodeID srcVar, NodeID dstVar)
     {
-        return getDFPTDataTy()->updateATVPts(srcVar,stmt->getId(),dstVar);
+        return getDFPTDataTy()->updateATVPts(topLevelRepNode(srcVar),stmt->getId(),dstVar);
     }
 
     inline void clearAllDFOutVarFlag(const SVFGNode* stmt)
@@ -273,19 +308,65 @@ protected:
     }
     ///@}
 
+    /// Collapse top-level variables on cycles of copies/phis of the SVFG (-fs-collapse-copy-scc).
+    /// Only copies/phis whose operands are in the same SCC of Andersen's constraint graph are
+    /// considered, and the cycles among them are exact equalities for SSA variables.
+    /// Copies/phis with all operands in the cycle are removed, and the remaining definitions
+    /// in the cycle are connected to all uses of the merged variables.
+    void collapseTopLevelCopySCCs(void);
+
     /// Performs clustering based on ander, setting the global best mapping
     /// accordingly.
     virtual void cluster(void);
     /// Sets the global best mapping as a plain mapping, i.e. n -> n.
     virtual void plainMap(void) const;
 
+    /// Online re-clustering (-cluster-fs-online).
+    /// Every so many processed nodes, the live points-to sets are copied and clustered in the
+    /// background while solving goes on. Once done, the new mapping is applied if it needs
+    /// fewer words for those points-to sets than the current one.
+    /// A clustering still running when solving ends is cancelled, then joined.
+    ///@{
+    struct OnlineClusterResult
+    {
+        std::vector<NodeID> mapping;
+        u64_t oldWords;
+        u64_t newWords;
+        Map<std::string, std::string> stats;
+        /// Statistics of the clustering itself, printed on the main thread
+        NodeIDAllocator::Clusterer::StatsList clusterStats;
+    };
+    /// Called after each processed node.
+    void reclusterOnline(void);
+    /// Remap all points-to sets to the result of a finished background clustering.
+    void applyOnlineCluster(void);
+    /// Cancel the background clustering, if any, and wait for its thread to stop.
+    void cancelOnlineCluster(void);
+    ///@}
+
     static FlowSensitive* fspta;
     SVFGBuilder memSSA;
     AndersenWaveDiff *ander;
 
+    /// Top-level variable to its representative, for variables merged by collapseTopLevelCopySCCs
+    NodeToNodeMap topLevelRep;
+    /// Representative to the remaining svfg nodes defining its merged variables, and the reverse
+    //@{
+    Map<NodeID, NodeBS> repToCollapsedDefs;
+    NodeToNodeMap collapsedDefToRep;
+    //@}
+
     /// Save candidate mappings for evaluation's sake.
     std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> candidateMappings;
 
+    /// Background clustering started by reclusterOnline, its result and the thread running it.
+    std::future<OnlineClusterResult> onlineCluster;
+    std::thread onlineClusterThread;
+    /// Set to give up the background clustering (checked between its steps and regions).
+    std::atomic<bool> onlineClusterCancelled;
+    u32_t numOfProcessedSinceRecluster;
+    u32_t numOfOnlineRemaps;
+
     /// Statistics.
     //@{
     Size_t numOfProcessedAddr;	/// Number of processed Addr node
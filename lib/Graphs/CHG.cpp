@@ -89,6 +89,70 @@ CHNode *CHGraph::getNode(const string name) const
 }
 
 
+/*
+ * Whether virtual function "callee" (found at the vtable index of callsite "cs")
+ * may be called at "cs" whose called function name is "funName"
+ */
+static bool isVCallTarget(CallSite cs, const string& funName, const SVFFunction* callee)
+{
+    if (cs.arg_size() != callee->arg_size() &&
+            !(cs.getFunctionType()->isVarArg() && callee->isVarArg()))
+        return false;
+
+    // if argument types do not match
+    // skip this one
+    if (!checkArgTypes(cs, callee->getLLVMFun()))
+        return false;
+
+    cppUtil::DemangledName dname = cppUtil::demangle(callee->getName().str());
+    string calleeName = dname.funcName;
+
+    /*
+     * The compiler will add some special suffix (e.g.,
+     * "[abi:cxx11]") to the end of some virtual function:
+     * In dealII
+     * function: FE_Q<3>::get_name
+     * will be mangled as: _ZNK4FE_QILi3EE8get_nameB5cxx11Ev
+     * after demangling: FE_Q<3>::get_name[abi:cxx11]
+     * The special suffix ("[abi:cxx11]") needs to be removed
+     */
+    const std::string suffix("[abi:cxx11]");
+    size_t suffix_pos = calleeName.rfind(suffix);
+    if (suffix_pos != string::npos)
+        calleeName.erase(suffix_pos, suffix.size());
+
+    /*
+     * if we can't get the function name of a virtual callsite, all virtual
+     * functions calculated by idx will be valid
+     */
+    if (funName.size() == 0)
+    {
+        return true;
+    }
+    else if (funName[0] == '~')
+    {
+        /*
+         * if the virtual callsite is calling a destructor, then all
+         * destructors in the ch will be valid
+         * class A { virtual ~A(){} };
+         * class B: public A { virtual ~B(){} };
+         * int main() {
+         *   A *a = new B;
+         *   delete a;  /// the function name of this virtual callsite is ~A()
+         * }
+         */
+        return calleeName[0] == '~';
+    }
+    else
+    {
+        /*
+         * for other virtual function calls, the function name of the callsite
+         * and the function name of the target callee should match exactly
+         */
+        return funName.compare(calleeName) == 0;
+    }
+}
+
 /*
  * Get virtual functions for callsite "cs" based on vtbls (calculated
  * based on pointsto set)
@@ -110,72 +174,65 @@ void CHGraph::getVFnsFromVtbls(CallSite cs, const VTableSet &vtbls, VFunSet &vir
         for (CHNode::FuncVector::const_iterator fit = vfns.begin(),
                 feit = vfns.end(); fit != feit; ++fit)
         {
-            const SVFFunction* callee = *fit;
-            if (cs.arg_size() == callee->arg_size() ||
-                    (cs.getFunctionType()->isVarArg() && callee->isVarArg()))
-            {
+            if (isVCallTarget(cs, funName, *fit))
+                virtualFunctions.insert(*fit);
+        }
+    }
+}
 
-                // if argument types do not match
-                // skip this one
-                if (!checkArgTypes(cs, callee->getLLVMFun()))
-                    continue;
-
-                cppUtil::DemangledName dname = cppUtil::demangle(callee->getName().str());
-                string calleeName = dname.funcName;
-
-                /*
-                 * The compiler will add some special suffix (e.g.,
-                 * "[abi:cxx11]") to the end of some virtual function:
-                 * In dealII
-                 * function: FE_Q<3>::get_name
-                 * will be mangled as: _ZNK4FE_QILi3EE8get_nameB5cxx11Ev
-                 * after demangling: FE_Q<3>::get_name[abi:cxx11]
-                 * The special suffix ("[abi:cxx11]") needs to be removed
-                 */
-                const std::string suffix("[abi:cxx11]");
-                size_t suffix_pos = calleeName.rfind(suffix);
-                if (suffix_pos != string::npos)
-                    calleeName.erase(suffix_pos, suffix.size());
-
-                /*
-                 * if we can't get the function name of a virtual callsite, all virtual
-                 * functions calculated by idx will be valid
-                 */
-                if (funName.size() == 0)
-                {
-                    virtualFunctions.insert(callee);
-                }
-                else if (funName[0] == '~')
-                {
-                    /*
-                     * if the virtual callsite is calling a destructor, then all
-                     * destructors in the ch will be valid
-                     * class A { virtual ~A(){} };
-                     * class B: public A { virtual ~B(){} };
-                     * int main() {
-                     *   A *a = new B;
-                     *   delete a;  /// the function name of this virtual callsite is ~A()
-                     * }
-                     */
-                    if (calleeName[0] == '~')
-                    {
-                        virtualFunctions.insert(callee);
-                    }
-                }
-                else
-                {
-                    /*
-                     * for other virtual function calls, the function name of the callsite
-                     * and the function name of the target callee should match exactly
-                     */
-                    if (funName.compare(calleeName) == 0)
-                    {
-                        virtualFunctions.insert(callee);
-                    }
-                }
+const VTableSet& CHGraph::getCHAVtbls(const CHNode* node)
+{
+    NodeID id = node->getId();
+    if (classToCHAVtblsBuilt[id] == false)
+    {
+        classToCHAVtblsBuilt[id] = true;
+        for (u32_t order : classClosure[id])
+        {
+            if (const GlobalValue *vtbl = dfsOrderToClass[order]->getVTable())
+                classToCHAVtbls[id].insert(vtbl);
+        }
+    }
+    return classToCHAVtbls[id];
+}
+
+const CHNode::FuncVector& CHGraph::getCHAVFns(const CHNode* node, u32_t idx)
+{
+    std::vector<VFnTableEntry>& table = classToCHAVFnTable[node->getId()];
+    if (table.size() <= idx)
+        table.resize(idx + 1);
+
+    VFnTableEntry& entry = table[idx];
+    if (entry.built == false)
+    {
+        entry.built = true;
+        /// the virtual functions of the classes having a vtable, as in getVFnsFromVtbls
+        Set<const SVFFunction*> visited;
+        for (u32_t order : classClosure[node->getId()])
+        {
+            const CHNode* cls = dfsOrderToClass[order];
+            if (cls->getVTable() == nullptr)
+                continue;
+            CHNode::FuncVector vfns;
+            cls->getVirtualFunctions(idx, vfns);
+            for (const SVFFunction* vfn : vfns)
+            {
+                if (visited.insert(vfn).second)
+                    entry.vfns.push_back(vfn);
             }
         }
     }
+    return entry.vfns;
+}
+
+void CHGraph::getVFnsFromCHA(CallSite cs, const CHNode* node, VFunSet &virtualFunctions)
+{
+    string funName = cppUtil::getFunNameOfVCallSite(cs);
+    const CHNode::FuncVector& vfns = getCHAVFns(node, cppUtil::getVCallIdx(cs));
+    for (const SVFFunction* vfn : vfns)
+    {
+        if (isVCallTarget(cs, funName, vfn))
+            virtualFunctions.insert(vfn);
+    }
 }
 
 
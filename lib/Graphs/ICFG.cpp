@@ -245,6 +245,20 @@ FunExitBlockNode* ICFG::getFunExitBlockNode(const SVFFunction*  fun)
         return b;
 }
 
+/// Add a node created elsewhere
+void ICFG::addBlockICFGNode(ICFGNode* node)
+{
+    addICFGNode(node);
+    if (IntraBlockNode* intra = SVFUtil::dyn_cast<IntraBlockNode>(node))
+        InstToBlockNodeMap[intra->getInst()] = intra;
+    else if (CallBlockNode* call = SVFUtil::dyn_cast<CallBlockNode>(node))
+        CSToCallNodeMap[call->getCallSite()] = call;
+    else if (RetBlockNode* ret = SVFUtil::dyn_cast<RetBlockNode>(node))
+        CSToRetNodeMap[ret->getCallSite()] = ret;
+    else
+        assert(false && "not an intra/call/ret node?");
+}
+
 /*!
  * Whether we has an intra ICFG edge
  */
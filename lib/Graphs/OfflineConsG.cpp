@@ -163,6 +163,84 @@ NodeID OfflineConsG::solveRep(OSCC* oscc, NodeID rep)
     return rep;
 }
 
+/*!
+ * Offline variable substitution by hash-based union (HU) over the offline constraint graph.
+ * SCCs are visited in topological order of copy edges, so the labels of all predecessors
+ * are known before a node is labelled.
+ */
+void OfflineConsG::solvePointerEquivalence(OSCC* oscc, const NodeBS& onlineNodes)
+{
+    // Labels of address-of objects and of unknown points-to sets do not collide
+    auto addrLabel = [](NodeID obj) { return obj << 1; };
+    auto freshLabel = [](NodeID node) { return (node << 1) | 1; };
+
+    Map<NodeID, NodeBS> labels;     // SCC rep (or node of an inexact SCC) --> label set
+    Map<NodeBS, NodeID> labelsToRep;
+    NodeStack topoOrder = oscc->topoNodeStack();
+    while (!topoOrder.empty())
+    {
+        NodeID rep = topoOrder.top();
+        topoOrder.pop();
+        const NodeBS& subNodes = oscc->subNodes(rep);
+
+        // A copy cycle is an equality, a cycle through a ref node (i.e. a load and a store) or
+        // a gep is not, and its nodes are labelled independently.
+        bool exact = true;
+        bool unknown = false;
+        NodeBS repLabels;
+        for (NodeID sub : subNodes)
+        {
+            if (isaRef(sub))
+                exact = false;
+            if (isaRef(sub) || onlineNodes.test(sub))
+                unknown = true;
+
+            ConstraintNode* node = getConstraintNode(sub);
+            for (ConstraintEdge* edge : node->getAddrInEdges())
+                repLabels.set(addrLabel(edge->getSrcID()));
+            for (ConstraintEdge* edge : node->getGepInEdges())
+            {
+                unknown = true;
+                if (subNodes.test(edge->getSrcID()))
+                    exact = false;
+            }
+            for (ConstraintEdge* edge : node->getCopyInEdges())
+            {
+                NodeID src = edge->getSrcID();
+                if (subNodes.test(src))
+                    continue;
+                Map<NodeID, NodeBS>::const_iterator it = labels.find(src);
+                if (it == labels.end())
+                    it = labels.find(oscc->repNode(src));
+                if (it != labels.end())
+                    repLabels |= it->second;
+            }
+        }
+
+        if (!exact)
+        {
+            for (NodeID sub : subNodes)
+                labels[sub].set(freshLabel(sub));
+            continue;
+        }
+
+        if (unknown)
+            repLabels.set(freshLabel(rep));
+        // Nodes pointing to nothing are left alone
+        if (repLabels.empty())
+            continue;
+
+        std::pair<Map<NodeBS, NodeID>::iterator, bool> res = labelsToRep.emplace(repLabels, rep);
+        NodeID peRep = res.first->second;
+        for (NodeID sub : subNodes)
+        {
+            if (sub != peRep)
+                peRepMap[sub] = peRep;
+        }
+        labels[rep] = std::move(repLabels);
+    }
+}
+
 /*!
  * Dump offline constraint graph
  */
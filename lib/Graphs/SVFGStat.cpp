@@ -144,6 +144,7 @@ SVFGStat::SVFGStat(SVFG* g) : PTAStat(nullptr)
     addTopLevelNodeTimeStart = addTopLevelNodeTimeEnd = 0;
     addAddrTakenNodeTimeStart = addAddrTakenNodeTimeEnd = 0;
     svfgOptTimeStart = svfgOptTimeEnd = 0;
+    numOfCollapsedVars = numOfCollapsedNodes = numOfCollapsedEdges = 0;
 }
 
 void SVFGStat::clear()
@@ -239,6 +240,10 @@ void SVFGStat::performStat()
     PTNumStatMap["MaxIndInDeg"] = maxIndInDegree;
     PTNumStatMap["MaxIndOutDeg"] = maxIndOutDegree;
 
+    PTNumStatMap["CollapsedTLVars"] = numOfCollapsedVars;
+    PTNumStatMap["CollapsedNodes"] = numOfCollapsedNodes;
+    PTNumStatMap["CollapsedEdges"] = numOfCollapsedEdges;
+
     printStat();
 }
 
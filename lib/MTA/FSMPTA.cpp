@@ -10,6 +10,8 @@
 #include "MTA/MHP.h"
 #include "MTA/PCG.h"
 #include "MemoryModel/PointsTo.h"
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -682,8 +684,8 @@ void MTASVFGBuilder::readPrecision()
 
 void MTASVFGBuilder::connectMHPEdges(PointerAnalysis* pta)
 {
-    PCG* pcg;
-    if (ADDEDGE_NONSPARSE==Options::AddModelFlag)
+    PCG* pcg = mhp->getPCG();
+    if (pcg == nullptr && ADDEDGE_NONSPARSE==Options::AddModelFlag)
     {
         pcg= new PCG(pta);
         pcg->analyze();
@@ -694,6 +696,25 @@ void MTASVFGBuilder::connectMHPEdges(PointerAnalysis* pta)
 
     /// todo: we ignore rule 2 and 3. but so far I haven't added intra-thread value flow affected by fork
     /// and inter-thread value flow affected by join
+    if (ADDEDGE_NONSPARSE==Options::AddModelFlag || ADDEDGE_NOALIAS==Options::AddModelFlag)
+        connectMHPEdgesForAllPairs(pta, pcg);
+    else
+        connectMHPEdgesForCandidatePairs(pta);
+
+    if(Options::ReadPrecisionTDEdge && ADDEDGE_NORP!=Options::AddModelFlag)
+    {
+        DBOUT(DGENERAL,outs()<<"Read precision edge removing \n");
+        DBOUT(DMTA,outs()<<"Read precision edge removing \n");
+        readPrecision();
+    }
+}
+
+/*!
+ * Examine every pair of stores and loads.
+ * Edges of the non-sparse and no-alias models do not require the two nodes to access a common object.
+ */
+void MTASVFGBuilder::connectMHPEdgesForAllPairs(PointerAnalysis* pta, PCG* pcg)
+{
     for (SVFGNodeSet::const_iterator it1 = stnodeSet.begin(), eit1 =  stnodeSet.end(); it1!=eit1; ++it1)
     {
         const StmtSVFGNode* n1 = SVFUtil::cast<StmtSVFGNode>(*it1);
@@ -743,12 +764,81 @@ void MTASVFGBuilder::connectMHPEdges(PointerAnalysis* pta)
             }
         }
     }
+}
 
-    if(Options::ReadPrecisionTDEdge && ADDEDGE_NORP!=Options::AddModelFlag)
+/*!
+ * Examine only the pairs of stores and loads which may access a common abstract object.
+ *
+ * Stores and loads are indexed by the objects pointed to by their address operands, so a pair
+ * is only examined if the points-to intersection on its edge would be non-empty. Collecting the
+ * partners of each store is independent and done on -td-edge-threads workers; the MHP, lock and
+ * edge insertion steps update caches and the SVFG and stay sequential.
+ */
+void MTASVFGBuilder::connectMHPEdgesForCandidatePairs(PointerAnalysis* pta)
+{
+    ObjToSVFGNodesMap objToStores;
+    ObjToSVFGNodesMap objToLoads;
+    std::vector<const StmtSVFGNode*> stores;
+    std::vector<NodeBS> storeObjs;
+
+    for (SVFGNodeSet::const_iterator it = stnodeSet.begin(), eit = stnodeSet.end(); it != eit; ++it)
     {
-        DBOUT(DGENERAL,outs()<<"Read precision edge removing \n");
-        DBOUT(DMTA,outs()<<"Read precision edge removing \n");
-        readPrecision();
+        const StmtSVFGNode* n = SVFUtil::cast<StmtSVFGNode>(*it);
+        const PointsTo& pts = pta->getPts(n->getPAGDstNodeID());
+        for (PointsTo::iterator o = pts.begin(), eo = pts.end(); o != eo; ++o)
+            objToStores[*o].set(n->getId());
+        stores.push_back(n);
+        storeObjs.push_back(pts.toNodeBS());
+    }
+    for (SVFGNodeSet::const_iterator it = ldnodeSet.begin(), eit = ldnodeSet.end(); it != eit; ++it)
+    {
+        const StmtSVFGNode* n = SVFUtil::cast<StmtSVFGNode>(*it);
+        const PointsTo& pts = pta->getPts(n->getPAGSrcNodeID());
+        for (PointsTo::iterator o = pts.begin(), eo = pts.end(); o != eo; ++o)
+            objToLoads[*o].set(n->getId());
+    }
+
+    /// partners of stores[i]: loads, and stores with a larger id so that each store pair is examined once
+    std::vector<SVFGNodeIDSet> loadPartners(stores.size());
+    std::vector<SVFGNodeIDSet> storePartners(stores.size());
+    std::atomic<u32_t> next(0);
+    auto collectPartners = [&]()
+    {
+        for (u32_t i = next++; i < stores.size(); i = next++)
+        {
+            NodeID id = stores[i]->getId();
+            for (NodeBS::iterator o = storeObjs[i].begin(), eo = storeObjs[i].end(); o != eo; ++o)
+            {
+                ObjToSVFGNodesMap::const_iterator lit = objToLoads.find(*o);
+                if (lit != objToLoads.end())
+                    loadPartners[i] |= lit->second;
+                ObjToSVFGNodesMap::const_iterator sit = objToStores.find(*o);
+                if (sit != objToStores.end())
+                {
+                    for (SVFGNodeIDSet::iterator s = sit->second.begin(), es = sit->second.end(); s != es; ++s)
+                    {
+                        if (*s > id)
+                            storePartners[i].set(*s);
+                    }
+                }
+            }
+        }
+    };
+    u32_t numOfThreads = std::max<u32_t>(1, std::min<u32_t>(Options::TDEdgeThreads, stores.size()));
+    std::vector<std::thread> workers;
+    for (u32_t i = 1; i < numOfThreads; ++i)
+        workers.push_back(std::thread(collectPartners));
+    collectPartners();
+    for (std::thread& t : workers)
+        t.join();
+
+    for (u32_t i = 0; i < stores.size(); ++i)
+    {
+        const StmtSVFGNode* n1 = stores[i];
+        for (SVFGNodeIDSet::iterator it = loadPartners[i].begin(), eit = loadPartners[i].end(); it != eit; ++it)
+            handleStoreLoad(n1, SVFUtil::cast<StmtSVFGNode>(svfg->getSVFGNode(*it)), pta);
+        for (SVFGNodeIDSet::iterator it = storePartners[i].begin(), eit = storePartners[i].end(); it != eit; ++it)
+            handleStoreStore(n1, SVFUtil::cast<StmtSVFGNode>(svfg->getSVFGNode(*it)), pta);
     }
 }
 
@@ -391,14 +391,90 @@ void LockAnalysis::analyzeLockSpanCxtStmt()
  */
 void LockAnalysis::printLocks(const CxtStmt& cts)
 {
-    const CxtLockSet & lockset = getCxtLockfromCxtStmt(cts);
-    outs() << "\nlock sets size = " << lockset.size() << "\n";
-    for (CxtLockSet::const_iterator it = lockset.begin(), eit = lockset.end(); it != eit; ++it)
+    const LockSet& lockset = getCxtLockfromCxtStmt(cts);
+    outs() << "\nlock sets size = " << lockset.count() << "\n";
+    for (LockSet::iterator it = lockset.begin(), eit = lockset.end(); it != eit; ++it)
     {
-        (*it).dump();
+        getCxtLock(*it).dump();
     }
 }
 
+/*!
+ * Intersect two interned locksets, the result is memoised for the pair
+ */
+LockAnalysis::LockSetID LockAnalysis::intersect(LockSetID lockset1, LockSetID lockset2)
+{
+    if (lockset1 == lockset2)
+        return lockset1;
+    LockSetPair key = lockset1 < lockset2 ? std::make_pair(lockset1, lockset2) : std::make_pair(lockset2, lockset1);
+    LockSetPairToLockSetID::const_iterator it = intersectCache.find(key);
+    if (it != intersectCache.end())
+        return it->second;
+
+    LockSet lockset = idToLockSet[lockset1] & idToLockSet[lockset2];
+    LockSetID res = internLockSet(lockset);
+    intersectCache[key] = res;
+    return res;
+}
+
+/*!
+ * Return true if two locksets has at least one alias lock, the result is memoised for the pair
+ */
+bool LockAnalysis::alias(LockSetID lockset1, LockSetID lockset2)
+{
+    LockSetPair key = lockset1 < lockset2 ? std::make_pair(lockset1, lockset2) : std::make_pair(lockset2, lockset1);
+    LockSetPairToBool::const_iterator it = aliasCache.find(key);
+    if (it != aliasCache.end())
+        return it->second;
+
+    bool res = false;
+    const LockSet& locks1 = idToLockSet[lockset1];
+    const LockSet& locks2 = idToLockSet[lockset2];
+    for (LockSet::iterator it1 = locks1.begin(), eit1 = locks1.end(); it1 != eit1 && !res; ++it1)
+    {
+        for (LockSet::iterator it2 = locks2.begin(), eit2 = locks2.end(); it2 != eit2; ++it2)
+        {
+            if (isAliasedLocks(getCxtLock(*it1), getCxtLock(*it2)))
+            {
+                res = true;
+                break;
+            }
+        }
+    }
+    aliasCache[key] = res;
+    return res;
+}
+
+/*!
+ * Map each context-sensitive statement to its context-sensitive locks
+ */
+LockAnalysis::CxtStmtToCxtLockSet LockAnalysis::getCSTCLS() const
+{
+    CxtStmtToCxtLockSet res;
+    for (CxtStmtToLockSetID::const_iterator it = cxtStmtToLockSetId.begin(), eit = cxtStmtToLockSetId.end(); it != eit; ++it)
+    {
+        CxtLockSet& locks = res[it->first];
+        const LockSet& lockset = idToLockSet[it->second];
+        for (LockSet::iterator lit = lockset.begin(), elit = lockset.end(); lit != elit; ++lit)
+            locks.insert(getCxtLock(*lit));
+    }
+    return res;
+}
+
+/*!
+ * Get the context-sensitive statements of a lock span
+ */
+LockAnalysis::LockSpan LockAnalysis::getSpanfromCxtLock(const CxtLock& cl) const
+{
+    CxtLockToID::const_iterator it = cxtLockToId.find(cl);
+    assert(it != cxtLockToId.end() && "context-sensitive lock not found!");
+    LockSpan span;
+    const NodeBS& stmts = lockSpans[it->second];
+    for (NodeBS::iterator sit = stmts.begin(), esit = stmts.end(); sit != esit; ++sit)
+        span.insert(idToCxtStmt[*sit]);
+    return span;
+}
+
 
 
 /// Handle fork
@@ -606,8 +682,8 @@ bool LockAnalysis::isProtectedByCommonCxtLock(const CxtStmt& cxtStmt1, const Cxt
 {
     if(!hasCxtLockfromCxtStmt(cxtStmt1) || !hasCxtLockfromCxtStmt(cxtStmt2))
         return true;
-    const CxtLockSet& lockset1 = getCxtLockfromCxtStmt(cxtStmt1);
-    const CxtLockSet& lockset2 = getCxtLockfromCxtStmt(cxtStmt2);
+    LockSetID lockset1 = getLockSetIDfromCxtStmt(cxtStmt1);
+    LockSetID lockset2 = getLockSetIDfromCxtStmt(cxtStmt2);
     if (alias(lockset1,lockset2))
         return true;
 
@@ -684,8 +760,8 @@ bool LockAnalysis::isInSameCSSpan(const CxtStmt& cxtStmt1, const CxtStmt& cxtStm
 {
     if(!hasCxtLockfromCxtStmt(cxtStmt1) || !hasCxtLockfromCxtStmt(cxtStmt2))
         return true;
-    const CxtLockSet& lockset1 = getCxtLockfromCxtStmt(cxtStmt1);
-    const CxtLockSet& lockset2 = getCxtLockfromCxtStmt(cxtStmt2);
+    LockSetID lockset1 = getLockSetIDfromCxtStmt(cxtStmt1);
+    LockSetID lockset2 = getLockSetIDfromCxtStmt(cxtStmt2);
     if (intersects(lockset1,lockset2))
         return true;
 
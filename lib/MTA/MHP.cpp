@@ -9,9 +9,13 @@
 #include "MTA/MHP.h"
 #include "MTA/MTA.h"
 #include "MTA/LockAnalysis.h"
+#include "MTA/PCG.h"
 #include "MTA/MTAResultValidator.h"
 #include "Util/SVFUtil.h"
 #include "MemoryModel/PTAStat.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -76,8 +80,8 @@ private:
 /*!
  * Constructor
  */
-MHP::MHP(TCT* t) :tcg(t->getThreadCallGraph()),tct(t),numOfTotalQueries(0),numOfMHPQueries(0),
-    interleavingTime(0),interleavingQueriesTime(0)
+MHP::MHP(TCT* t) :tcg(t->getThreadCallGraph()),tct(t),pcg(nullptr),solveInParallel(false),hasInterleavingClasses(false),numOfTotalQueries(0),numOfMHPQueries(0),
+    numOfPrefilteredQueries(0),interleavingTime(0),interleavingQueriesTime(0)
 {
     fja = new ForkJoinAnalysis(tct);
     fja->analyzeForkJoinPair();
@@ -89,6 +93,7 @@ MHP::MHP(TCT* t) :tcg(t->getThreadCallGraph()),tct(t),numOfTotalQueries(0),numOf
 MHP::~MHP()
 {
     delete fja;
+    delete pcg;
 }
 
 /*!
@@ -100,7 +105,15 @@ void MHP::analyze()
     DBOUT(DGENERAL, outs() << pasMsg("MHP interleaving analysis\n"));
     DBOUT(DMTA, outs() << pasMsg("MHP interleaving analysis\n"));
     DOTIMESTAT(double interleavingStart = PTAStat::getClk(true));
-    analyzeInterleaving();
+    if(Options::MHPPCGPrefilter)
+    {
+        pcg = new PCG(tct->getPTA());
+        pcg->analyze();
+    }
+    if(Options::MHPThreads > 1)
+        analyzeInterleavingInParallel();
+    else
+        analyzeInterleaving();
     DOTIMESTAT(double interleavingEnd = PTAStat::getClk(true));
     DOTIMESTAT(interleavingTime += (interleavingEnd - interleavingStart) / TIMEINTERVAL);
 
@@ -125,58 +138,372 @@ void MHP::analyzeInterleaving()
         while(!cxtStmtList.empty())
         {
             CxtThreadStmt cts = popFromCTSWorkList();
-            const Instruction* curInst = cts.getStmt();
-            DBOUT(DMTA,outs() << "-----\nMHP analysis root thread: " << rootTid << " ");
-            DBOUT(DMTA,cts.dump());
-            DBOUT(DMTA,outs() << "current thread interleaving: < ");
-            DBOUT(DMTA,dumpSet(getInterleavingThreads(cts)));
-            DBOUT(DMTA,outs() << " >\n-----\n");
-
-            /// handle non-candidate function
-            if (!tct->isCandidateFun(curInst->getParent()->getParent()))
+            processCxtThreadStmt(cts,rootTid);
+        }
+    }
+
+    /// update non-candidate functions' interleaving
+    updateNonCandidateFunInterleaving();
+
+    if(Options::MHPQueryClasses)
+        buildInterleavingClasses();
+
+
+    if(Options::PrintInterLev)
+        printInterleaving();
+	
+    validateResults();
+}
+
+/*!
+ * Analyze thread interleaving in parallel.
+ *
+ * All threads are seeded first (the seeds of a thread only depend on the TCT), then the
+ * threads are solved level by level following their depth in the TCT. The threads of one
+ * level are independent: statements only propagate within their own thread, except fork
+ * sites which flow into the entry of a child thread at the next level. Each thread owns a
+ * shard of the analysis state, so workers never write to the same map, and the buffered
+ * fork propagations are applied once a level is done.
+ */
+void MHP::analyzeInterleavingInParallel()
+{
+    /// Fill the is_ext cache before workers start querying it
+    SVFModule* module = tct->getSVFModule();
+    for (SVFModule::iterator F = module->begin(), E = module->end(); F != E; ++F)
+        isExtCall(*F);
+
+    shards.clear();
+    shards.resize(tct->getTCTNodeNum());
+    solveInParallel = true;
+
+    for(TCT::const_iterator it = tct->begin(), eit = tct->end(); it!=eit; ++it)
+    {
+        const CxtThread& ct = it->second->getCxtThread();
+        NodeID rootTid = it->first;
+        const Function* routine = tct->getStartRoutineOfCxtThread(ct);
+        CxtThreadStmt rootcts(rootTid,ct.getContext(),&(routine->getEntryBlock().front()));
+
+        addInterleavingThread(rootcts,rootTid);
+        updateAncestorThreads(rootTid);
+        updateSiblingThreads(rootTid);
+    }
+
+    std::vector<std::vector<NodeID> > levels;
+    getThreadsByTCTDepth(levels);
+
+    /// one sweep reaches the fixpoint on a tree-shaped TCT, repeat until no work is left in any case
+    bool pending = true;
+    while(pending)
+    {
+        for(const std::vector<NodeID>& level : levels)
+        {
+            std::vector<NodeID> tids;
+            for(NodeID tid : level)
             {
-                handleNonCandidateFun(cts);
+                if(!shards[tid].worklist.empty())
+                    tids.push_back(tid);
             }
-            /// handle candidate function
-            else
+            if(tids.empty())
+                continue;
+
+            std::atomic<u32_t> next(0);
+            auto worker = [this, &tids, &next]()
             {
-                if(isTDFork(curInst))
-                {
-                    handleFork(cts,rootTid);
-                }
-                else if(isTDJoin(curInst))
-                {
-                    handleJoin(cts,rootTid);
-                }
-                else if(SVFUtil::isa<CallInst>(curInst) && !isExtCall(curInst))
-                {
-                    handleCall(cts,rootTid);
-                    PTACallGraph::FunctionSet callees;
-                    if(!tct->isCandidateFun(getCallee(curInst, callees)))
-                       handleIntra(cts);
-                }
-                else if(SVFUtil::isa<ReturnInst>(curInst))
-                {
-                    handleRet(cts);
-                }
-                else
-                {
-                    handleIntra(cts);
-                }
+                for(u32_t i = next++; i < tids.size(); i = next++)
+                    solveInterleavingShard(tids[i]);
+            };
+            u32_t numOfThreads = std::min<u32_t>(Options::MHPThreads, tids.size());
+            std::vector<std::thread> workers;
+            for(u32_t i = 1; i < numOfThreads; ++i)
+                workers.push_back(std::thread(worker));
+            worker();
+            for(std::thread& t : workers)
+                t.join();
+
+            /// propagate into the entries of forked threads
+            for(NodeID tid : tids)
+            {
+                for(const std::pair<CxtThreadStmt,NodeBS>& fork : shards[tid].forkedInterleav)
+                    addInterleavingThread(fork.first,fork.second);
+                shards[tid].forkedInterleav.clear();
+            }
+        }
+
+        pending = false;
+        for(const InterleavingShard& shard : shards)
+        {
+            if(!shard.worklist.empty())
+            {
+                pending = true;
+                break;
             }
         }
     }
 
+    mergeInterleavingShards();
+    solveInParallel = false;
+
     /// update non-candidate functions' interleaving
     updateNonCandidateFunInterleaving();
 
+    if(Options::MHPQueryClasses)
+        buildInterleavingClasses();
 
     if(Options::PrintInterLev)
         printInterleaving();
-	
+
     validateResults();
 }
 
+/*!
+ * Process a statement of the worklist
+ */
+void MHP::processCxtThreadStmt(const CxtThreadStmt& cts, NodeID rootTid)
+{
+    const Instruction* curInst = cts.getStmt();
+    DBOUT(DMTA,outs() << "-----\nMHP analysis root thread: " << rootTid << " ");
+    DBOUT(DMTA,cts.dump());
+    DBOUT(DMTA,outs() << "current thread interleaving: < ");
+    DBOUT(DMTA,dumpSet(getInterleavingThreadsForUpdate(cts)));
+    DBOUT(DMTA,outs() << " >\n-----\n");
+
+    /// handle non-candidate function
+    if (!tct->isCandidateFun(curInst->getParent()->getParent()))
+    {
+        handleNonCandidateFun(cts);
+    }
+    /// handle candidate function
+    else
+    {
+        if(isTDFork(curInst))
+        {
+            handleFork(cts,rootTid);
+        }
+        else if(isTDJoin(curInst))
+        {
+            handleJoin(cts,rootTid);
+        }
+        else if(SVFUtil::isa<CallInst>(curInst) && !isExtCall(curInst))
+        {
+            handleCall(cts,rootTid);
+            PTACallGraph::FunctionSet callees;
+            if(!tct->isCandidateFun(getCallee(curInst, callees)))
+               handleIntra(cts);
+        }
+        else if(SVFUtil::isa<ReturnInst>(curInst))
+        {
+            handleRet(cts);
+        }
+        else
+        {
+            handleIntra(cts);
+        }
+    }
+}
+
+/*!
+ * Drain the worklist of a thread
+ */
+void MHP::solveInterleavingShard(NodeID tid)
+{
+    CxtThreadStmtWorkList& worklist = shards[tid].worklist;
+    while(!worklist.empty())
+    {
+        CxtThreadStmt cts = worklist.pop();
+        processCxtThreadStmt(cts,tid);
+    }
+}
+
+/*!
+ * Group threads by their depth in the TCT (breadth-first from the root threads)
+ */
+void MHP::getThreadsByTCTDepth(std::vector<std::vector<NodeID> >& levels) const
+{
+    NodeBS visited;
+    std::vector<NodeID> curLevel;
+    for(TCT::const_iterator it = tct->begin(), eit = tct->end(); it!=eit; ++it)
+    {
+        if(it->second->getInEdges().empty())
+        {
+            curLevel.push_back(it->first);
+            visited.set(it->first);
+        }
+    }
+
+    while(!curLevel.empty())
+    {
+        std::vector<NodeID> nextLevel;
+        for(NodeID tid : curLevel)
+        {
+            const TCTNode* node = tct->getTCTNode(tid);
+            for(TCT::ThreadCreateEdgeSet::const_iterator eit = node->getOutEdges().begin(), eeit = node->getOutEdges().end(); eit!=eeit; ++eit)
+            {
+                NodeID child = (*eit)->getDstID();
+                if(visited.test_and_set(child))
+                    nextLevel.push_back(child);
+            }
+        }
+        levels.push_back(curLevel);
+        curLevel.swap(nextLevel);
+    }
+
+    /// threads not reachable from a root (e.g., on a creation cycle) are solved last
+    std::vector<NodeID> rest;
+    for(TCT::const_iterator it = tct->begin(), eit = tct->end(); it!=eit; ++it)
+    {
+        if(!visited.test(it->first))
+            rest.push_back(it->first);
+    }
+    for(NodeID tid : rest)
+        levels.push_back(std::vector<NodeID>(1,tid));
+}
+
+/*!
+ * Move the per-thread results into the maps used by MHP queries
+ */
+void MHP::mergeInterleavingShards()
+{
+    for(InterleavingShard& shard : shards)
+    {
+        for(ThreadStmtToThreadInterleav::value_type& it : shard.threadStmtToTheadInterLeav)
+            threadStmtToTheadInterLeav[it.first] = std::move(it.second);
+        for(InstToThreadStmtSetMap::value_type& it : shard.instToTSMap)
+            instToTSMap[it.first].insert(it.second.begin(), it.second.end());
+    }
+    shards.clear();
+}
+
+/*!
+ * Assign interleaving classes to instructions.
+ *
+ * Whether two instructions may happen in parallel only depends on the distinct
+ * (thread, interleaving threads) pairs of their thread statements, so instructions
+ * sharing these pairs fall into one class. The MHP relation is then precomputed
+ * as a bit matrix between classes.
+ */
+void MHP::buildInterleavingClasses()
+{
+    instToClass.clear();
+    classToInsts.clear();
+    classMHPMatrix.clear();
+
+    OrderedMap<std::vector<u32_t>, u32_t> sigToClass;
+    std::vector<InterleavingSignature> classSigs;
+    for(InstToThreadStmtSetMap::const_iterator it = instToTSMap.begin(), eit = instToTSMap.end(); it!=eit; ++it)
+    {
+        /// canonical encoding of the pairs: thread id followed by its interleaving threads
+        std::vector<std::vector<u32_t> > pairs;
+        for(const CxtThreadStmt& cts : it->second)
+        {
+            const NodeBS& lev = getInterleavingThreads(cts);
+            std::vector<u32_t> pair(1, cts.getTid());
+            for(NodeBS::iterator lit = lev.begin(), elit = lev.end(); lit!=elit; ++lit)
+                pair.push_back(*lit);
+            pairs.push_back(pair);
+        }
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+        std::vector<u32_t> key;
+        for(const std::vector<u32_t>& pair : pairs)
+        {
+            key.push_back(pair.size());
+            key.insert(key.end(), pair.begin(), pair.end());
+        }
+
+        std::pair<OrderedMap<std::vector<u32_t>, u32_t>::iterator, bool> res = sigToClass.emplace(key, classSigs.size());
+        if(res.second)
+        {
+            InterleavingSignature sig;
+            for(const std::vector<u32_t>& pair : pairs)
+            {
+                NodeBS lev;
+                for(u32_t i = 1; i < pair.size(); ++i)
+                    lev.set(pair[i]);
+                sig.push_back(std::make_pair(pair[0], lev));
+            }
+            classSigs.push_back(sig);
+            classToInsts.push_back(InstVec());
+        }
+        instToClass[it->first] = res.first->second;
+        classToInsts[res.first->second].push_back(it->first);
+    }
+
+    /// threads and interleaving threads of each class to skip pairs of classes quickly
+    u32_t numOfClasses = classSigs.size();
+    std::vector<NodeBS> classTids(numOfClasses), classLevs(numOfClasses);
+    for(u32_t c = 0; c < numOfClasses; ++c)
+    {
+        for(const std::pair<NodeID,NodeBS>& p : classSigs[c])
+        {
+            classTids[c].set(p.first);
+            classLevs[c] |= p.second;
+        }
+    }
+
+    classMHPMatrix.resize(numOfClasses);
+    for(u32_t c1 = 0; c1 < numOfClasses; ++c1)
+    {
+        for(u32_t c2 = c1; c2 < numOfClasses; ++c2)
+        {
+            if(!classLevs[c1].intersects(classTids[c2]) && !classTids[c1].intersects(classTids[c2]))
+                continue;
+            if(isMHPSignature(classSigs[c1], classSigs[c2]))
+            {
+                classMHPMatrix[c1].set(c2);
+                classMHPMatrix[c2].set(c1);
+            }
+        }
+    }
+    hasInterleavingClasses = true;
+
+    DBOUT(DMTA, outs() << "interleaving classes: " << numOfClasses << " for " << instToClass.size() << " instructions\n");
+}
+
+/*!
+ * The pairwise check of mayHappenInParallelInst over two interleaving signatures
+ */
+bool MHP::isMHPSignature(const InterleavingSignature& sig1, const InterleavingSignature& sig2)
+{
+    for(const std::pair<NodeID,NodeBS>& p1 : sig1)
+    {
+        for(const std::pair<NodeID,NodeBS>& p2 : sig2)
+        {
+            if(p1.first != p2.first)
+            {
+                if(p1.second.test(p2.first) && p2.second.test(p1.first))
+                    return true;
+            }
+            else if(isMultiForkedThread(p1.first))
+                return true;
+        }
+    }
+    return false;
+}
+
+/*!
+ * Collect all instructions which may happen in parallel with inst
+ */
+void MHP::getMHPInstructions(const Instruction* inst, InstSet& mhpInsts)
+{
+    if(!hasInterleavingClasses)
+    {
+        for(InstToThreadStmtSetMap::const_iterator it = instToTSMap.begin(), eit = instToTSMap.end(); it!=eit; ++it)
+        {
+            if(mayHappenInParallelInst(inst, it->first))
+                mhpInsts.insert(it->first);
+        }
+        return;
+    }
+
+    InstToInterleavingClassMap::const_iterator it = instToClass.find(inst);
+    if(it==instToClass.end())
+        return;
+    const NodeBS& row = classMHPMatrix[it->second];
+    for(NodeBS::iterator cit = row.begin(), ecit = row.end(); cit!=ecit; ++cit)
+        mhpInsts.insert(classToInsts[*cit].begin(), classToInsts[*cit].end());
+}
+
 /*!
  * Update non-candidate functions' interleaving
  */
@@ -258,7 +585,11 @@ void MHP::handleFork(const CxtThreadStmt& cts, NodeID rootTid)
             const Instruction* stmt = &(routine->getEntryBlock().front());
             CxtThread ct(newCxt,call);
             CxtThreadStmt newcts(tct->getTCTNode(ct)->getId(),ct.getContext(),stmt);
-            addInterleavingThread(newcts,cts);
+            /// the child thread is solved by another worker, defer the propagation
+            if(solveInParallel)
+                shards[cts.getTid()].forkedInterleav.push_back(std::make_pair(newcts,getInterleavingThreadsForUpdate(cts)));
+            else
+                addInterleavingThread(newcts,cts);
         }
     }
     handleIntra(cts);
@@ -519,6 +850,12 @@ bool MHP::isMustJoin(NodeID curTid, const Instruction* joinsite)
 NodeBS MHP::getDirAndIndJoinedTid(const CallStrCxt& cxt, const Instruction* call)
 {
     CxtStmt cs(cxt,call);
+    /// ForkJoinAnalysis caches joined threads lazily
+    if(solveInParallel)
+    {
+        std::lock_guard<std::mutex> lock(fjaMutex);
+        return fja->getDirAndIndJoinedTid(cs);
+    }
     return fja->getDirAndIndJoinedTid(cs);
 }
 
@@ -616,6 +953,18 @@ bool MHP::mayHappenInParallelInst(const Instruction* i1, const Instruction* i2)
 
 bool MHP::mayHappenInParallelCache(const Instruction* i1, const Instruction* i2)
 {
+    if(hasInterleavingClasses)
+    {
+        /// instructions without thread statements (e.g., in dead functions) have no class and never happen in parallel
+        InstToInterleavingClassMap::const_iterator it1 = instToClass.find(i1);
+        InstToInterleavingClassMap::const_iterator it2 = instToClass.find(i2);
+        if(it1==instToClass.end() || it2==instToClass.end())
+            return false;
+        bool mhp = classMHPMatrix[it1->second].test(it2->second);
+        if(mhp)
+            numOfMHPQueries++;
+        return mhp;
+    }
     if(!tct->isCandidateFun(i1->getParent()->getParent()) &&!tct->isCandidateFun(i2->getParent()->getParent()))
     {
         FuncPair funpair = std::make_pair(i1->getParent()->getParent(), i2->getParent()->getParent());
@@ -640,6 +989,13 @@ bool MHP::mayHappenInParallel(const Instruction* i1, const Instruction* i2)
 {
     numOfTotalQueries++;
 
+    /// two instructions never happen in parallel if their functions don't
+    if(pcg && !pcg->mayHappenInParallel(i1,i2))
+    {
+        numOfPrefilteredQueries++;
+        return false;
+    }
+
     DOTIMESTAT(double queryStart = PTAStat::getClk());
     bool mhp=mayHappenInParallelCache(i1,i2);
     DOTIMESTAT(double queryEnd = PTAStat::getClk());
@@ -13,6 +13,7 @@
 #include "MTA/MTAStat.h"
 #include "WPA/Andersen.h"
 #include "MTA/FSMPTA.h"
+#include "MTA/MTAReportSink.h"
 #include "Util/SVFUtil.h"
 #include "SVF-FE/SVFIRBuilder.h"
 
@@ -56,8 +57,16 @@ bool MTA::runOnModule(SVFModule* module)
 
     modulePass = this;
 
+    /// results streamed by a phase are written out when it ends
+    MTAReportSink* sink = MTAReportSink::getReportSink();
     MHP* mhp = computeMHP(module);
+    sink->flush();
     LockAnalysis* lsa = computeLocksets(mhp->getTCT());
+    sink->flush();
+
+    /// the racy pairs are only streamed out with -mta-report
+    if (sink->isEnabled())
+        detect(module, mhp, lsa);
 
 
 
@@ -102,6 +111,9 @@ bool MTA::runOnModule(SVFModule* module)
     delete mhp;
     delete lsa;
 
+    /// write out the remaining streamed results
+    MTAReportSink::releaseReportSink();
+
     return false;
 }
 
@@ -162,7 +174,7 @@ MHP* MTA::computeMHP(SVFModule* module)
 // * when two memory access may-happen in parallel and are not protected by the same lock
 // * (excluding global constraints because they are initialized before running the main function)
 // */
-void MTA::detect(SVFModule* module)
+void MTA::detect(SVFModule* module, MHP* mhp, LockAnalysis* lsa)
 {
 
     DBOUT(DGENERAL, outs() << pasMsg("Starting Race Detection\n"));
@@ -189,6 +201,9 @@ void MTA::detect(SVFModule* module)
         }
     }
 
+    PointerAnalysis* pta = mhp->getTCT()->getPTA();
+    MTAReportSink* sink = MTAReportSink::getReportSink();
+    u64_t numOfRaces = 0;
     for (LoadSet::const_iterator lit = loads.begin(), elit = loads.end(); lit != elit; ++lit)
     {
         const LoadInst* load = *lit;
@@ -197,13 +212,32 @@ void MTA::detect(SVFModule* module)
         {
             const StoreInst* store = *sit;
 
+            if (!pta->alias(load->getPointerOperand(), store->getPointerOperand()))
+                continue;
+            if (!mhp->mayHappenInParallel(store, load))
+                continue;
+
             loadneedcheck = true;
             needcheckinst.insert(store);
+
+            /// only the pairs passing every check are streamed as races
+            bool protect = lsa->isProtectedByCommonLock(store, load);
+            sink->reportLock(store, load, protect);
+            if (!protect)
+            {
+                sink->reportRace(store, load);
+                numOfRaces++;
+            }
         }
         if (loadneedcheck)
             needcheckinst.insert(load);
     }
 
+    for (const Instruction* inst : needcheckinst)
+        sink->reportNeedCheck(inst);
+    sink->flush();
+
     outs() << "HP needcheck: " << needcheckinst.size() << "\n";
+    outs() << "HP races: " << numOfRaces << "\n";
 }
 
@@ -8,6 +8,7 @@
 #include "Util/Options.h"
 #include "MTA/MTAAnnotator.h"
 #include "MTA/LockAnalysis.h"
+#include "MTA/MTAReportSink.h"
 #include "MemoryModel/PointsTo.h"
 #include <sstream>
 
@@ -206,6 +207,7 @@ void MTAAnnotator::pruneAliasMHP(PointerAnalysis* pta)
         return;
 
     DBOUT(DGENERAL, outs() << pasMsg("Run annotator prune Alias or MHP pairs\n"));
+    MTAReportSink* sink = MTAReportSink::getReportSink();
     InstSet needannost;
     InstSet needannold;
     for (InstSet::iterator it1 = storeset.begin(), eit1 = storeset.end(); it1 != eit1; ++it1)
@@ -217,8 +219,14 @@ void MTAAnnotator::pruneAliasMHP(PointerAnalysis* pta)
 
             if (AnnoMHP)
             {
-                if (mhp->mayHappenInParallel(*it1, *it2) && !lsa->isProtectedByCommonLock(*it1, *it2))
+                if (mhp->mayHappenInParallel(*it1, *it2) && !isProtectedByCommonLock(*it1, *it2))
                 {
+                    /// streamed races are not kept for annotation
+                    if (sink->isEnabled())
+                    {
+                        sink->reportRace(*it1, *it2);
+                        continue;
+                    }
                     needannost.insert(*it1);
                     needannost.insert(*it2);
                 }
@@ -239,8 +247,13 @@ void MTAAnnotator::pruneAliasMHP(PointerAnalysis* pta)
 
             if (AnnoMHP)
             {
-                if (mhp->mayHappenInParallel(*it1, *it2) && !lsa->isProtectedByCommonLock(*it1, *it2))
+                if (mhp->mayHappenInParallel(*it1, *it2) && !isProtectedByCommonLock(*it1, *it2))
                 {
+                    if (sink->isEnabled())
+                    {
+                        sink->reportRace(*it1, *it2);
+                        continue;
+                    }
                     needannost.insert(*it1);
                     needannold.insert(*it2);
                 }
@@ -254,6 +267,7 @@ void MTAAnnotator::pruneAliasMHP(PointerAnalysis* pta)
     }
     storeset = needannost;
     loadset = needannold;
+    sink->flush();
 
     if (AnnoMHP)
     {
@@ -266,6 +280,14 @@ void MTAAnnotator::pruneAliasMHP(PointerAnalysis* pta)
         numOfAliasLd = loadset.size();
     }
 }
+
+bool MTAAnnotator::isProtectedByCommonLock(const Instruction* i1, const Instruction* i2)
+{
+    bool protect = lsa->isProtectedByCommonLock(i1, i2);
+    MTAReportSink::getReportSink()->reportLock(i1, i2, protect);
+    return protect;
+}
+
 void MTAAnnotator::performAnnotate()
 {
     if (!Options::AnnoFlag)
@@ -0,0 +1,151 @@
+/*
+ * MTAReportSink.cpp
+ *
+ * Streaming sink for the results of multithreaded program analysis
+ */
+
+#include "Util/Options.h"
+#include "MTA/MTAReportSink.h"
+#include "Util/SVFUtil.h"
+#include <cstdlib>
+
+using namespace SVF;
+using namespace SVFUtil;
+
+MTAReportSink* MTAReportSink::reportSink = nullptr;
+
+/// Maximum number of cached source locations
+static const u32_t MaxCachedLocs = 1 << 16;
+
+/*!
+ * Constructor
+ */
+MTAReportSink::MTAReportSink() : os(nullptr), numOfReports(0), lastFlush(std::chrono::steady_clock::now())
+{
+    bufferLimit = static_cast<u64_t>(Options::MTAReportBufferSize) * 1024;
+    if (Options::MTAReportFile.empty())
+        return;
+
+    std::error_code EC;
+    os = new raw_fd_ostream(Options::MTAReportFile.c_str(), EC, llvm::sys::fs::OF_Text);
+    if (EC)
+    {
+        writeWrnMsg("cannot open report file " + Options::MTAReportFile + ": " + EC.message());
+        delete os;
+        os = nullptr;
+        return;
+    }
+
+    static bool atExitRegistered = false;
+    if (!atExitRegistered)
+    {
+        std::atexit(flushAtExit);
+        atExitRegistered = true;
+    }
+}
+
+/*!
+ * Destructor
+ */
+MTAReportSink::~MTAReportSink()
+{
+    if (os)
+    {
+        flush();
+        delete os;
+    }
+}
+
+/*!
+ * Compose a line for a pair query
+ */
+void MTAReportSink::report(ReportKind kind, const Instruction* i1, const Instruction* i2, bool res)
+{
+    switch (kind)
+    {
+    case MHPPair:
+        line = "MHP";
+        break;
+    case LockPair:
+        line = "LOCK";
+        break;
+    case RacePair:
+        line = "RACE";
+        break;
+    default:
+        assert(false && "validation results are reported by reportValidation");
+    }
+    line += "\t";
+    line += getLoc(i1);
+    line += "\t";
+    line += getLoc(i2);
+    line += res ? "\t1" : "\t0";
+    append();
+}
+
+void MTAReportSink::reportValidation(const char* scenario, const Instruction* i1, const Instruction* i2, bool res, bool expected)
+{
+    if (!isEnabled())
+        return;
+
+    line = "VALID\t";
+    line += scenario;
+    line += "\t";
+    line += getLoc(i1);
+    line += "\t";
+    line += getLoc(i2);
+    line += res ? "\t1" : "\t0";
+    line += expected ? "\t1" : "\t0";
+    append();
+}
+
+/*!
+ * Write out the buffered lines when the program exits without releasing the sink
+ */
+void MTAReportSink::flushAtExit()
+{
+    if (reportSink)
+        reportSink->flush();
+}
+
+void MTAReportSink::reportNeedCheck(const Instruction* inst)
+{
+    if (!isEnabled())
+        return;
+
+    line = "NEEDCHECK\t";
+    line += getLoc(inst);
+    append();
+}
+
+void MTAReportSink::append()
+{
+    buffer += line;
+    buffer += "\n";
+    numOfReports++;
+
+    if (buffer.size() >= bufferLimit
+            || std::chrono::steady_clock::now() - lastFlush >= std::chrono::milliseconds(Options::MTAReportFlushMs))
+        flush();
+}
+
+void MTAReportSink::flush()
+{
+    if (os == nullptr)
+        return;
+    os->write(buffer.data(), buffer.size());
+    os->flush();
+    buffer.clear();
+    lastFlush = std::chrono::steady_clock::now();
+}
+
+const std::string& MTAReportSink::getLoc(const Instruction* inst)
+{
+    Map<const Instruction*, std::string>::const_iterator it = instToLoc.find(inst);
+    if (it != instToLoc.end())
+        return it->second;
+
+    if (instToLoc.size() >= MaxCachedLocs)
+        instToLoc.clear();
+    return instToLoc[inst] = getSourceLoc(inst);
+}
@@ -12,6 +12,7 @@
 #include "MTA/LockAnalysis.h"
 #include "MTA/FSMPTA.h"
 #include "MTA/MTAAnnotator.h"
+#include "MTA/MTAReportSink.h"
 #include "Graphs/ThreadCallGraph.h"
 
 using namespace SVF;
@@ -120,13 +121,16 @@ void MTAStat::performMHPPairStat(MHP* mhp, LockAnalysis* lsa)
         }
 
 
+        MTAReportSink* sink = MTAReportSink::getReportSink();
         for(InstSet::const_iterator it1 = instSet1.begin(), eit1 = instSet1.end(); it1!=eit1; ++it1)
         {
             for(InstSet::const_iterator it2 = instSet2.begin(), eit2 = instSet2.end(); it2!=eit2; ++it2)
             {
-                mhp->mayHappenInParallel(*it1,*it2);
+                bool mhpRes = mhp->mayHappenInParallel(*it1,*it2);
+                sink->reportMHP(*it1,*it2,mhpRes);
             }
         }
+        sink->flush();
     }
 
 
@@ -135,9 +139,12 @@ void MTAStat::performMHPPairStat(MHP* mhp, LockAnalysis* lsa)
     timeStatMap.clear();
     PTNumStatMap["TotalMHPQueries"] = mhp->numOfTotalQueries;
     PTNumStatMap["NumOfMHPPairs"] = mhp->numOfMHPQueries;
+    PTNumStatMap["NumOfPCGFilteredQueries"] = mhp->numOfPrefilteredQueries;
+    PTNumStatMap["NumOfInterleavingClasses"] = mhp->getInterleavingClassNum();
     PTNumStatMap["TotalLockQueries"] = lsa->numOfTotalQueries;
     PTNumStatMap["NumOfLockedPairs"] = lsa->numOfLockedQueries;
     PTNumStatMap["NumOfCxtLocks"] = lsa->getNumOfCxtLocks();
+    PTNumStatMap["NumOfLockSets"] = lsa->getNumOfLockSets();
     PTNumStatMap["NumOfNewSVFGEdges"] = MTASVFGBuilder::numOfNewSVFGEdges;
     PTNumStatMap["NumOfRemovedEdges"] = MTASVFGBuilder::numOfRemovedSVFGEdges;
     PTNumStatMap["NumOfRemovedPTS"] = MTASVFGBuilder::numOfRemovedPTS;
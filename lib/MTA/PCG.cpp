@@ -29,6 +29,8 @@ bool PCG::analyze()
 
     inferFromCallGraph();
 
+    buildMHPFunMatrix();
+
     //interferenceAnalysis();
 
     //if (Options::TDPrint) {
@@ -40,6 +42,15 @@ bool PCG::analyze()
 
 bool PCG::mayHappenInParallelBetweenFunctions(const Function* fun1, const Function* fun2) const
 {
+    if (!mhpFunSpawnees.empty())
+    {
+        FunToIDMap::const_iterator it1 = funToMatrixID.find(fun1);
+        FunToIDMap::const_iterator it2 = funToMatrixID.find(fun2);
+        if (it1 == funToMatrixID.end() || it2 == funToMatrixID.end())
+            return false;
+        return mhpFunSpawnees[it1->second] || mhpFunSpawnees[it2->second];
+    }
+
     // if neither of functions are spawnees, then they won't happen in parallel
     if (isSpawneeFun(fun1) == false && isSpawneeFun(fun2) == false)
         return false;
@@ -60,6 +71,27 @@ bool PCG::mayHappenInParallel(const Instruction* i1, const Instruction* i2) cons
 }
 
 
+/*!
+ * Index the spawners, spawnees and followers and record which of them are spawnees.
+ * Two indexed functions may happen in parallel iff either is a spawnee, so two bit tests
+ * replace the set membership tests of the queries.
+ */
+void PCG::buildMHPFunMatrix()
+{
+    funToMatrixID.clear();
+    mhpFunSpawnees.clear();
+
+    for (SVFModule::const_iterator fi = mod->begin(), efi = mod->end(); fi != efi; ++fi)
+    {
+        const Function* fun = (*fi)->getLLVMFun();
+        if (isSpawnerFun(fun) || isSpawneeFun(fun) || isFollowerFun(fun))
+        {
+            funToMatrixID[fun] = mhpFunSpawnees.size();
+            mhpFunSpawnees.push_back(isSpawneeFun(fun));
+        }
+    }
+}
+
 /*!
  * Initialize thread spawners and spawnees from threadAPI functions
  * a procedure is a spawner if it creates a thread and the created thread is still existent on its return
@@ -82,7 +114,18 @@ void PCG::initFromThreadAPI(SVFModule* module)
                     spawners.insert(fun);
                     spawnees.insert(forkFun);
                 }
-                /// TODO: handle indirect call here for the fork Fun
+                /// the spawnees of an indirect fork are resolved by the thread call graph
+                else if (ThreadCallGraph* tcg = SVFUtil::dyn_cast<ThreadCallGraph>(callgraph))
+                {
+                    CallBlockNode* cbn = getCallBlockNode(inst);
+                    addSpawnsite(inst);
+                    spawners.insert(fun);
+                    if (tcg->hasThreadForkEdge(cbn))
+                    {
+                        for (ThreadCallGraph::ForkEdgeSet::const_iterator it = tcg->getForkEdgeBegin(cbn), eit = tcg->getForkEdgeEnd(cbn); it != eit; ++it)
+                            spawnees.insert((*it)->getDstNode()->getFunction()->getLLVMFun());
+                    }
+                }
                 else
                 {
                     writeWrnMsg("pthread create");
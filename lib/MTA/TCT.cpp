@@ -11,6 +11,8 @@
 #include "SVF-FE/DataFlowUtil.h"
 
 #include <string>
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -220,13 +222,20 @@ void TCT::collectMultiForkedThreads()
  * Handle call relations
  */
 void TCT::handleCallRelation(CxtThreadProc& ctp, const PTACallGraphEdge* cgEdge, CallSite cs)
+{
+    CallStrCxt cxt(ctp.getContext());
+    pushCxt(cxt,cs.getInstruction(),cgEdge->getDstNode()->getFunction()->getLLVMFun());
+    handleCallRelation(ctp,cgEdge,cs,cxt);
+}
+
+/*!
+ * Handle call relations given the context of the callee
+ */
+void TCT::handleCallRelation(CxtThreadProc& ctp, const PTACallGraphEdge* cgEdge, CallSite cs, const CallStrCxt& cxt)
 {
 	const SVFFunction* callee = cgEdge->getDstNode()->getFunction();
     const Function* llvmcallee = callee->getLLVMFun();
-
-    CallStrCxt cxt(ctp.getContext());
-    CallStrCxt oldCxt = cxt;
-    pushCxt(cxt,cs.getInstruction(),llvmcallee);
+    const CallStrCxt& oldCxt = ctp.getContext();
 
     if(cgEdge->getEdgeKind() == PTACallGraphEdge::CallRetEdge)
     {
@@ -387,6 +396,9 @@ void TCT::build()
 
     markRelProcs();
 
+    if(Options::TCTThreads > 1)
+        buildCFInfoForCandidateFuns();
+
     collectLoopInfoForJoin();
 
     // the fork site of main function is initialized with nullptr.
@@ -404,30 +416,15 @@ void TCT::build()
         pushToCTPWorkList(t);
     }
 
+    if(Options::TCTThreads > 1)
+        expandCxtThreadProcsInParallel();
+
     while(!ctpList.empty())
     {
         CxtThreadProc ctp = popFromCTPWorkList();
-        PTACallGraphNode* cgNode = tcg->getCallGraphNode(ctp.getProc());
-        if(isCandidateFun(cgNode->getFunction()->getLLVMFun()) == false)
-            continue;
-
-        for(PTACallGraphNode::const_iterator nit = cgNode->OutEdgeBegin(), neit = cgNode->OutEdgeEnd(); nit!=neit; nit++)
-        {
-            const PTACallGraphEdge* cgEdge = (*nit);
-
-            for(PTACallGraphEdge::CallInstSet::const_iterator cit = cgEdge->directCallsBegin(),
-                    ecit = cgEdge->directCallsEnd(); cit!=ecit; ++cit)
-            {
-                DBOUT(DMTA,outs() << "\nTCT handling direct call:" << **cit << "\t" << cgEdge->getSrcNode()->getFunction()->getName() << "-->" << cgEdge->getDstNode()->getFunction()->getName() << "\n");
-                handleCallRelation(ctp,cgEdge,getLLVMCallSite((*cit)->getCallSite()));
-            }
-            for(PTACallGraphEdge::CallInstSet::const_iterator ind = cgEdge->indirectCallsBegin(),
-                    eind = cgEdge->indirectCallsEnd(); ind!=eind; ++ind)
-            {
-                DBOUT(DMTA,outs() << "\nTCT handling indirect call:" << **ind << "\t" << cgEdge->getSrcNode()->getFunction()->getName() << "-->" << cgEdge->getDstNode()->getFunction()->getName() << "\n");
-                handleCallRelation(ctp,cgEdge,getLLVMCallSite((*ind)->getCallSite()));
-            }
-        }
+        CallRelations rels;
+        collectCallRelations(ctp, rels);
+        handleCallRelations(ctp, rels);
     }
 
     collectMultiForkedThreads();
@@ -440,6 +437,93 @@ void TCT::build()
 
 }
 
+/*!
+ * Compute loop, dominator and post-dominator info of candidate functions up front.
+ * ScalarEvolution is obtained from the legacy pass manager (MTA::getSE) which is not thread-safe, so it stays on-demand.
+ */
+void TCT::buildCFInfoForCandidateFuns()
+{
+    std::vector<const Function*> funs(candidateFuncSet.begin(), candidateFuncSet.end());
+    loopInfoBuilder.buildCFInfo(funs, Options::TCTThreads);
+}
+
+/*!
+ * Collect the call relations of a procedure under a thread context.
+ * Only read-only queries are performed, so procedures can be processed concurrently.
+ */
+void TCT::collectCallRelations(const CxtThreadProc& ctp, CallRelations& rels)
+{
+    PTACallGraphNode* cgNode = tcg->getCallGraphNode(ctp.getProc());
+    if(isCandidateFun(cgNode->getFunction()->getLLVMFun()) == false)
+        return;
+
+    for(PTACallGraphNode::const_iterator nit = cgNode->OutEdgeBegin(), neit = cgNode->OutEdgeEnd(); nit!=neit; nit++)
+    {
+        const PTACallGraphEdge* cgEdge = (*nit);
+        const Function* callee = cgEdge->getDstNode()->getFunction()->getLLVMFun();
+
+        for(PTACallGraphEdge::CallInstSet::const_iterator cit = cgEdge->directCallsBegin(),
+                ecit = cgEdge->directCallsEnd(); cit!=ecit; ++cit)
+        {
+            CallStrCxt cxt(ctp.getContext());
+            pushCxt(cxt,(*cit)->getCallSite(),callee);
+            rels.push_back(CallRelation(cgEdge,*cit,false,cxt));
+        }
+        for(PTACallGraphEdge::CallInstSet::const_iterator ind = cgEdge->indirectCallsBegin(),
+                eind = cgEdge->indirectCallsEnd(); ind!=eind; ++ind)
+        {
+            CallStrCxt cxt(ctp.getContext());
+            pushCxt(cxt,(*ind)->getCallSite(),callee);
+            rels.push_back(CallRelation(cgEdge,*ind,true,cxt));
+        }
+    }
+}
+
+/*!
+ * Handle the call relations of a procedure under a thread context, in the order they were collected
+ */
+void TCT::handleCallRelations(CxtThreadProc& ctp, const CallRelations& rels)
+{
+    for(const CallRelation& rel : rels)
+    {
+        const PTACallGraphEdge* cgEdge = rel.cgEdge;
+        DBOUT(DMTA,outs() << "\nTCT handling " << (rel.indirect ? "indirect" : "direct") << " call:" << *rel.call << "\t" << cgEdge->getSrcNode()->getFunction()->getName() << "-->" << cgEdge->getDstNode()->getFunction()->getName() << "\n");
+        handleCallRelation(ctp,cgEdge,getLLVMCallSite(rel.call->getCallSite()),rel.cxt);
+    }
+}
+
+/*!
+ * Drain the CxtThreadProc worklist round by round.
+ * The procedures of a round are expanded concurrently, their call relations are then applied
+ * in worklist order, so TCT nodes are created in the same order as the sequential traversal.
+ */
+void TCT::expandCxtThreadProcsInParallel()
+{
+    while(!ctpList.empty())
+    {
+        std::vector<CxtThreadProc> ctps;
+        while(!ctpList.empty())
+            ctps.push_back(popFromCTPWorkList());
+
+        std::vector<CallRelations> rels(ctps.size());
+        std::atomic<u32_t> next(0);
+        auto worker = [&]()
+        {
+            for(u32_t i = next++; i < ctps.size(); i = next++)
+                collectCallRelations(ctps[i], rels[i]);
+        };
+        std::vector<std::thread> workers;
+        for(u32_t i = 1; i < Options::TCTThreads && i < ctps.size(); ++i)
+            workers.push_back(std::thread(worker));
+        worker();
+        for(std::thread& t : workers)
+            t.join();
+
+        for(u32_t i = 0; i < ctps.size(); ++i)
+            handleCallRelations(ctps[i], rels[i]);
+    }
+}
+
 /*!
  *  Get the next instructions following control flow
  */
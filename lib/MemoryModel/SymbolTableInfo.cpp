@@ -34,6 +34,8 @@
 #include "Util/Options.h"
 #include "Util/SVFModule.h"
 #include "Util/SVFUtil.h"
+#include <atomic>
+#include <thread>
 
 using namespace std;
 using namespace SVF;
@@ -82,6 +84,29 @@ void SymbolTableInfo::collectTypeInfo(const Type* ty)
 }
 
 
+/*!
+ * Size of a type in bytes under the given data layout, 0 if the type is not sized
+ */
+static u32_t getLayoutTypeSize(const DataLayout& layout, const Type* type)
+{
+    if(type->isSized())
+        return layout.getTypeStoreSize(const_cast<Type*>(type));
+    else
+        return 0;
+}
+
+/*!
+ * Offset of a field of a struct under the given data layout
+ */
+static u32_t getLayoutFieldOffset(const DataLayout& layout, const StructType *sty, u32_t field_idx)
+{
+    /// if this struct type does not have any element, i.e., opaque
+    if(sty->isOpaque())
+        return 0;
+    else
+        return layout.getStructLayout(const_cast<StructType *>(sty))->getElementOffset(field_idx);
+}
+
 /*!
  * Fill in StInfo for an array type.
  */
@@ -89,15 +114,19 @@ void SymbolTableInfo::collectArrayInfo(const ArrayType* ty)
 {
     StInfo* stinfo = new StInfo();
     typeToFieldInfo[ty] = stinfo;
+    fillArrayInfo(stinfo, ty, *getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule()));
+}
 
+void SymbolTableInfo::fillArrayInfo(StInfo* stinfo, const ArrayType* ty, const DataLayout& layout)
+{
     u64_t out_num = ty->getNumElements();
     const llvm::Type* elemTy = ty->getElementType();
-    u32_t out_stride = getTypeSizeInBytes(elemTy);
+    u32_t out_stride = getLayoutTypeSize(layout, elemTy);
     while (const ArrayType* aty = SVFUtil::dyn_cast<ArrayType>(elemTy))
     {
         out_num *= aty->getNumElements();
         elemTy = aty->getElementType();
-        out_stride = getTypeSizeInBytes(elemTy);
+        out_stride = getLayoutTypeSize(layout, elemTy);
     }
 
     /// Array itself only has one field which is the inner most element
@@ -130,7 +159,18 @@ void SymbolTableInfo::collectStructInfo(const StructType *sty)
     /// The struct info should not be processed before
     StInfo* stinfo = new StInfo();
     typeToFieldInfo[sty] = stinfo;
+    u32_t nf = fillStructInfo(stinfo, sty, *getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule()));
+
+    //Record the size of the complete struct and update max_struct.
+    if (nf > maxStSize)
+    {
+        maxStruct = sty;
+        maxStSize = nf;
+    }
+}
 
+u32_t SymbolTableInfo::fillStructInfo(StInfo* stinfo, const StructType *sty, const DataLayout& layout)
+{
     // Number of fields after flattening the struct
     u32_t nf = 0;
     // field of the current struct
@@ -140,7 +180,7 @@ void SymbolTableInfo::collectStructInfo(const StructType *sty)
     {
         const Type *et = *it;
         // This offset is computed after alignment with the current struct
-        u64_t eOffsetInBytes = getTypeSizeInBytes(sty, field_idx);
+        u64_t eOffsetInBytes = getLayoutFieldOffset(layout, sty, field_idx);
         //The offset is where this element will be placed in the exp. struct.
         /// FIXME: As the layout size is uint_64, here we assume
         /// offset with uint_32 (Size_t) is large enough and will not cause overflow
@@ -172,13 +212,7 @@ void SymbolTableInfo::collectStructInfo(const StructType *sty)
             ++nf;
         }
     }
-
-    //Record the size of the complete struct and update max_struct.
-    if (nf > maxStSize)
-    {
-        maxStruct = sty;
-        maxStSize = nf;
-    }
+    return nf;
 }
 
 
@@ -189,7 +223,11 @@ void SymbolTableInfo::collectSimpleTypeInfo(const Type* ty)
 {
     StInfo* stinfo = new StInfo();
     typeToFieldInfo[ty] = stinfo;
+    fillSimpleTypeInfo(stinfo, ty);
+}
 
+void SymbolTableInfo::fillSimpleTypeInfo(StInfo* stinfo, const Type* ty)
+{
     /// Only one field
     stinfo->addFldWithType(0,0, ty);
 
@@ -199,6 +237,109 @@ void SymbolTableInfo::collectSimpleTypeInfo(const Type* ty)
     stinfo->getFlattenFieldInfoVec().push_back(field);
 }
 
+/*!
+ * Types whose StInfo is read when filling the StInfo of a type
+ */
+static void getElementTypesOfTypeInfo(const Type* ty, std::vector<const Type*>& elemTys)
+{
+    if (const ArrayType* aty = SVFUtil::dyn_cast<ArrayType>(ty))
+    {
+        const Type* elemTy = aty->getElementType();
+        while (const ArrayType* innerTy = SVFUtil::dyn_cast<ArrayType>(elemTy))
+            elemTy = innerTy->getElementType();
+        elemTys.push_back(elemTy);
+    }
+    else if (const StructType* sty = SVFUtil::dyn_cast<StructType>(ty))
+    {
+        for (const Type* et : sty->elements())
+        {
+            if (SVFUtil::isa<StructType>(et) || SVFUtil::isa<ArrayType>(et))
+                elemTys.push_back(et);
+        }
+    }
+}
+
+/*!
+ * Level of a type whose StInfo is not collected yet: 1 + the highest level of its element types,
+ * where types already collected are of level 0. Types are appended to their levels.
+ */
+u32_t SymbolTableInfo::getTypeInfoLevel(const Type* ty, Map<const Type*, u32_t>& typeToLevel, std::vector<std::vector<const Type*>>& levels) const
+{
+    if (typeToFieldInfo.find(ty) != typeToFieldInfo.end())
+        return 0;
+    Map<const Type*, u32_t>::const_iterator it = typeToLevel.find(ty);
+    if (it != typeToLevel.end())
+        return it->second;
+
+    std::vector<const Type*> elemTys;
+    getElementTypesOfTypeInfo(ty, elemTys);
+    u32_t level = 1;
+    for (const Type* elemTy : elemTys)
+        level = std::max(level, getTypeInfoLevel(elemTy, typeToLevel, levels) + 1);
+
+    typeToLevel[ty] = level;
+    if (levels.size() < level)
+        levels.resize(level);
+    levels[level - 1].push_back(ty);
+    return level;
+}
+
+/*!
+ * Collect the StInfo of the given types, and of the types they are made of, on multiple threads.
+ * Types are handled level by level so that the StInfo of the element types of a type are already
+ * collected when the type is filled in. The threads only read typeToFieldInfo, each of them with its
+ * own copy of the data layout (which caches struct layouts); the StInfo of a level are recorded
+ * after all its types are filled in.
+ */
+void SymbolTableInfo::collectTypeInfo(const std::vector<const Type*>& types, u32_t numThreads)
+{
+    Map<const Type*, u32_t> typeToLevel;
+    std::vector<std::vector<const Type*>> levels;
+    for (const Type* ty : types)
+        getTypeInfoLevel(ty, typeToLevel, levels);
+
+    const DataLayout& mainLayout = *getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule());
+    std::vector<DataLayout> layouts(std::max(1u, numThreads), mainLayout);
+
+    for (const std::vector<const Type*>& level : levels)
+    {
+        std::vector<StInfo*> stInfos(level.size());
+        std::vector<u32_t> numOfFlattenFields(level.size(), 0);
+        std::atomic<u32_t> nextType(0);
+        auto fill = [&](u32_t t)
+        {
+            for (u32_t i = nextType++; i < level.size(); i = nextType++)
+            {
+                const Type* ty = level[i];
+                stInfos[i] = new StInfo();
+                if (const ArrayType* aty = SVFUtil::dyn_cast<ArrayType>(ty))
+                    fillArrayInfo(stInfos[i], aty, layouts[t]);
+                else if (const StructType* sty = SVFUtil::dyn_cast<StructType>(ty))
+                    numOfFlattenFields[i] = fillStructInfo(stInfos[i], sty, layouts[t]);
+                else
+                    fillSimpleTypeInfo(stInfos[i], ty);
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (u32_t t = 1; t < std::min<u32_t>(layouts.size(), level.size()); ++t)
+            workers.emplace_back(fill, t);
+        fill(0);
+        for (std::thread& worker : workers)
+            worker.join();
+
+        for (u32_t i = 0; i < level.size(); ++i)
+        {
+            typeToFieldInfo[level[i]] = stInfos[i];
+            if (numOfFlattenFields[i] > maxStSize)
+            {
+                maxStruct = level[i];
+                maxStSize = numOfFlattenFields[i];
+            }
+        }
+    }
+}
+
 /*!
  * Compute gep offset
  */
@@ -657,23 +798,12 @@ void SymbolTableInfo::dump()
  */
 u32_t SymbolTableInfo::getTypeSizeInBytes(const Type* type)
 {
-
-    // if the type has size then simply return it, otherwise just return 0
-    if(type->isSized())
-        return  getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule())->getTypeStoreSize(const_cast<Type*>(type));
-    else
-        return 0;
+    return getLayoutTypeSize(*getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule()), type);
 }
 
 u32_t SymbolTableInfo::getTypeSizeInBytes(const StructType *sty, u32_t field_idx)
 {
-
-    const StructLayout *stTySL = getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule())->getStructLayout( const_cast<StructType *>(sty) );
-    /// if this struct type does not have any element, i.e., opaque
-    if(sty->isOpaque())
-        return 0;
-    else
-        return stTySL->getElementOffset(field_idx);
+    return getLayoutFieldOffset(*getDataLayout(LLVMModuleSet::getLLVMModuleSet()->getMainLLVMModule()), sty, field_idx);
 }
 
 
@@ -34,6 +34,10 @@
 #include "Util/DPItem.h"
 #include "Graphs/SVFG.h"
 #include <climits>
+#include <atomic>
+#include <thread>
+#include <llvm/ADT/DepthFirstIterator.h>
+#include <llvm/ADT/PostOrderIterator.h>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -50,22 +54,28 @@ u32_t ContextCond::maximumPath = 0;
  */
 void PathCondAllocator::allocate(const SVFModule* M)
 {
+    /// conditions of a function are allocated when a guard computation first reaches it
+    if (Options::LazyPathCond)
+        return;
+
     DBOUT(DGENERAL,outs() << pasMsg("path condition allocation starts\n"));
 
+    std::vector<const Function*> funs;
     for (const auto& func : *M)
     {
-        if (!SVFUtil::isExtCall(func))
-        {
-            // Allocate conditions for a program.
-            for (Function::const_iterator bit = func->getLLVMFun()->begin(), ebit = func->getLLVMFun()->end(); bit != ebit; ++bit)
-            {
-                const BasicBlock & bb = *bit;
-                collectBBCallingProgExit(bb);
-                allocateForBB(bb);
-            }
-        }
+        if (!SVFUtil::isExtCall(func) && allocatedFuns.find(func->getLLVMFun()) == allocatedFuns.end())
+            funs.push_back(func->getLLVMFun());
     }
 
+    u32_t numThreads = std::max(1u, std::min<u32_t>(Options::PathCondThreads, funs.size()));
+    if (numThreads == 1)
+    {
+        for (const Function* fun : funs)
+            allocateForFun(fun);
+    }
+    else
+        allocateForFuns(funs, numThreads);
+
     if(Options::PrintPathCond)
         printPathCond();
 
@@ -73,58 +83,200 @@ void PathCondAllocator::allocate(const SVFModule* M)
 }
 
 /*!
- * Allocate conditions for a basic block and propagate its condition to its successors.
+ * Allocate conditions for all basic blocks of a function (once)
  */
-void PathCondAllocator::allocateForBB(const BasicBlock & bb)
+void PathCondAllocator::allocateForFun(const Function* fun)
 {
+    if (!allocatedFuns.insert(fun).second)
+        return;
 
-    u32_t succ_number = getBBSuccessorNum(&bb);
+    std::vector<const BasicBlock*> bbs;
+    getBBsInVarOrder(fun, bbs);
+    for (const BasicBlock* bb : bbs)
+    {
+        collectBBCallingProgExit(*bb);
+        allocateForBB(*bb);
+    }
+}
 
-    // if successor number greater than 1, allocate new decision variable for successors
-    if(succ_number > 1)
+/*!
+ * Allocate conditions for the basic blocks of functions on numThreads threads, each with its own
+ * condition manager. The basic blocks (whose dominator trees are built lazily), their condition
+ * variables, numbered as the serial allocation does, and the blocks calling program exit are
+ * collected serially. The threads then build the conditions of the successors in their managers,
+ * and these conditions are translated into condMgr once the threads are joined.
+ */
+void PathCondAllocator::allocateForFuns(const std::vector<const Function*>& funs, u32_t numThreads)
+{
+    /// Blocks with several successors and their first condition variable, and the conditions
+    /// of their successors in the manager of the thread which built them
+    struct FunConds
     {
+        std::vector<std::pair<const BasicBlock*, u32_t>> branches;
+        std::vector<SuccCondVec> succConds;
+        const CondManager* mgr;
+    };
+    std::vector<FunConds> funConds(funs.size());
+    for (u32_t i = 0; i < funs.size(); ++i)
+    {
+        allocatedFuns.insert(funs[i]);
+        std::vector<const BasicBlock*> bbs;
+        getBBsInVarOrder(funs[i], bbs);
+        for (const BasicBlock* bb : bbs)
+        {
+            collectBBCallingProgExit(*bb);
+            if (u32_t numVars = getNumOfBranchCondVars(*bb))
+                funConds[i].branches.push_back(std::make_pair(bb, CondManager::reserveFreshBranchConds(numVars)));
+        }
+    }
+
+    std::vector<CondManager*> threadMgrs(numThreads);
+    for (CondManager*& mgr : threadMgrs)
+        mgr = CondManager::createThreadCondMgr();
 
-        //allocate log2(num_succ) decision variables
-        double num = log(succ_number)/log(2);
-        u32_t bit_num = (u32_t)ceil(num);
-        u32_t succ_index = 0;
-        std::vector<Condition*> condVec;
-        for(u32_t i = 0 ; i < bit_num; i++)
+    std::atomic<u32_t> nextFun(0);
+    auto build = [&](u32_t t)
+    {
+        CondManager::setThreadCondMgr(threadMgrs[t]);
+        for (u32_t i = nextFun++; i < funs.size(); i = nextFun++)
         {
-            condVec.push_back(newCond(bb.getTerminator()));
+            FunConds& fc = funConds[i];
+            fc.mgr = threadMgrs[t];
+            fc.succConds.resize(fc.branches.size());
+            for (u32_t b = 0; b < fc.branches.size(); ++b)
+                getSuccConds(*fc.branches[b].first, threadMgrs[t], fc.branches[b].second, fc.succConds[b]);
         }
+        CondManager::setThreadCondMgr(nullptr);
+    };
+
+    std::vector<std::thread> workers;
+    for (u32_t t = 1; t < numThreads; ++t)
+        workers.emplace_back(build, t);
+    build(0);
+    for (std::thread& worker : workers)
+        worker.join();
 
-        // iterate each successor
-        for (succ_const_iterator succ_it = succ_begin(&bb);
-             succ_it != succ_end(&bb);
-             succ_it++, succ_index++)
+    for (const FunConds& fc : funConds)
+    {
+        for (u32_t b = 0; b < fc.branches.size(); ++b)
         {
+            for (const std::pair<const BasicBlock*, Condition*>& succCond : fc.succConds[b])
+                setBranchCond(fc.branches[b].first, succCond.first, condMgr->translate(succCond.second, fc.mgr));
+        }
+    }
 
-            const BasicBlock* succ = *succ_it;
+    for (CondManager* mgr : threadMgrs)
+        delete mgr;
+}
+
+/*!
+ * Collect basic blocks of a function in the order of allocating their condition variables,
+ * which is also the initial BDD variable order.
+ * Allocating along the dominator tree (or reverse post-order) places the variables of a branch
+ * before those of the branches it dominates, which keeps BDDs of path conditions small.
+ * Unreachable blocks (not visited by the traversal) are appended in layout order.
+ */
+void PathCondAllocator::getBBsInVarOrder(const Function* fun, std::vector<const BasicBlock*>& bbs)
+{
+    const std::string& order = Options::BddVarOrder;
+    Set<const BasicBlock*> visited;
+    if (order == "dom")
+    {
+        for (const DomTreeNode* node : llvm::depth_first(getDT(fun)->getRootNode()))
+        {
+            bbs.push_back(node->getBlock());
+            visited.insert(node->getBlock());
+        }
+    }
+    else if (order == "rpo")
+    {
+        llvm::ReversePostOrderTraversal<const Function*> rpot(fun);
+        for (const BasicBlock* bb : rpot)
+        {
+            bbs.push_back(bb);
+            visited.insert(bb);
+        }
+    }
+    else if (order != "layout")
+        writeWrnMsg("unknown bdd variable order " + order + ", layout order is used\n");
+
+    for (const BasicBlock& bb : *fun)
+    {
+        if (visited.find(&bb) == visited.end())
+            bbs.push_back(&bb);
+    }
+}
+
+/*!
+ * Allocate conditions for a basic block and propagate its condition to its successors.
+ */
+void PathCondAllocator::allocateForBB(const BasicBlock & bb)
+{
+    // if successor number greater than 1, allocate new decision variables for successors
+    if (u32_t numVars = getNumOfBranchCondVars(bb))
+    {
+        SuccCondVec succConds;
+        getSuccConds(bb, condMgr, CondManager::reserveFreshBranchConds(numVars), succConds);
+        for (const std::pair<const BasicBlock*, Condition*>& succCond : succConds)
+            setBranchCond(&bb, succCond.first, succCond.second);
+    }
+}
+
+/*!
+ * Number of decision variables, i.e., log2(num_succ), of a basic block (0 if it does not branch)
+ */
+u32_t PathCondAllocator::getNumOfBranchCondVars(const BasicBlock& bb)
+{
+    u32_t succ_number = getBBSuccessorNum(&bb);
+    if (succ_number <= 1)
+        return 0;
+    double num = log(succ_number)/log(2);
+    return (u32_t)ceil(num);
+}
+
+/*!
+ * Build the condition of each successor of a basic block in mgr, from the decision variables
+ * numbered firstVar onwards
+ */
+void PathCondAllocator::getSuccConds(const BasicBlock& bb, CondManager* mgr, u32_t firstVar, SuccCondVec& succConds)
+{
+    u32_t bit_num = getNumOfBranchCondVars(bb);
+    std::vector<Condition*> condVec;
+    for(u32_t i = 0 ; i < bit_num; i++)
+    {
+        condVec.push_back(mgr->getOrAddFreshBranchCond(firstVar + i, bb.getTerminator()));
+    }
+
+    // iterate each successor
+    u32_t succ_index = 0;
+    for (succ_const_iterator succ_it = succ_begin(&bb);
+         succ_it != succ_end(&bb);
+         succ_it++, succ_index++)
+    {
+
+        const BasicBlock* succ = *succ_it;
 
-            Condition* path_cond = getTrueCond();
+        Condition* path_cond = mgr->getTrueCond();
 
-            ///TODO: handle BranchInst and SwitchInst individually here!!
+        ///TODO: handle BranchInst and SwitchInst individually here!!
 
-            // for each successor decide its bit representation
-            // decide whether each bit of succ_index is 1 or 0, if (three successor) succ_index is 000 then use C1^C2^C3
-            // if 001 use C1^C2^negC3
-            for(u32_t j = 0 ; j < bit_num; j++)
+        // for each successor decide its bit representation
+        // decide whether each bit of succ_index is 1 or 0, if (three successor) succ_index is 000 then use C1^C2^C3
+        // if 001 use C1^C2^negC3
+        for(u32_t j = 0 ; j < bit_num; j++)
+        {
+            //test each bit of this successor's index (binary representation)
+            u32_t tool = 0x01 << j;
+            if(tool & succ_index)
             {
-                //test each bit of this successor's index (binary representation)
-                u32_t tool = 0x01 << j;
-                if(tool & succ_index)
-                {
-                    path_cond = condAnd(path_cond, (condNeg(condVec.at(j))));
-                }
-                else
-                {
-                    path_cond = condAnd(path_cond, condVec.at(j));
-                }
+                path_cond = mgr->AND(path_cond, (mgr->NEG(condVec.at(j))));
+            }
+            else
+            {
+                path_cond = mgr->AND(path_cond, condVec.at(j));
             }
-            setBranchCond(&bb,succ,path_cond);
         }
-
+        succConds.push_back(std::make_pair(succ, path_cond));
     }
 }
 
@@ -480,6 +632,9 @@ PathCondAllocator::Condition* PathCondAllocator::ComputeIntraVFGGuard(const Basi
 
     assert(srcBB->getParent() == dstBB->getParent() && "two basic blocks are not in the same function??");
 
+    /// allocate branch conditions on demand with -lazy-pc
+    allocateForFun(srcBB->getParent());
+
     PostDominatorTree* postDT = getPostDT(srcBB->getParent());
     if(postDT->dominates(dstBB,srcBB))
         return getTrueCond();
@@ -555,4 +710,8 @@ void PathCondAllocator::printPathCond()
             }
         }
     }
+    outs() << "z3 sat cache hits: " << getSatCacheHitNum() << ", misses: " << getSatCacheMissNum()
+           << ", solving time: " << getSolverTime() << "\n";
+    outs() << "bdd peak nodes: " << getBddPeakNodeNum() << ", reorderings: " << getBddReorderNum()
+           << ", reordering time (ms): " << getBddReorderTime() << "\n";
 }
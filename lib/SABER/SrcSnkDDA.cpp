@@ -304,4 +304,10 @@ void SrcSnkDDA::printBDDStat()
 
     outs() << "BDD Mem usage: " << getPathAllocator()->getMemUsage() << "\n";
     outs() << "BDD Number: " << getPathAllocator()->getCondNum() << "\n";
+    outs() << "Z3 SAT Cache Hits: " << getPathAllocator()->getSatCacheHitNum() << "\n";
+    outs() << "Z3 SAT Cache Misses: " << getPathAllocator()->getSatCacheMissNum() << "\n";
+    outs() << "Z3 Solving Time: " << getPathAllocator()->getSolverTime() << "\n";
+    outs() << "BDD Peak Nodes: " << getPathAllocator()->getBddPeakNodeNum() << "\n";
+    outs() << "BDD Reorderings: " << getPathAllocator()->getBddReorderNum() << "\n";
+    outs() << "BDD Reordering Time (ms): " << getPathAllocator()->getBddReorderTime() << "\n";
 }
@@ -156,7 +156,7 @@ void CHGBuilder::buildCHGEdges(const SVFFunction* fun)
 
 void CHGBuilder::buildInternalMaps()
 {
-    buildClassNameToAncestorsDescendantsMap();
+    buildClassHierarchyClosure();
     buildVirtualFunctionToIDMap();
     buildCSToCHAVtblsAndVfnsMap();
 }
@@ -261,78 +261,106 @@ CHNode *CHGBuilder::createNode(const std::string className)
 }
 
 /*
- * build the following two maps:
- * classNameToDescendantsMap
- * chg->classNameToAncestorsMap
+ * Build the transitive closure of the class hierarchy.
+ *
+ * Classes are numbered in DFS (pre-)order from base classes to derived classes
+ * (and from templates to their instances), so that the descendants of a class
+ * mostly get consecutive numbers, i.e., few intervals in a bit vector.
+ *
+ * The closure of a class is a bit vector of the DFS orders of the class, its
+ * descendants and, for a template, its instances and their descendants.
  */
-void CHGBuilder::buildClassNameToAncestorsDescendantsMap()
+void CHGBuilder::buildClassHierarchyClosure()
 {
+    u32_t numOfClasses = chg->getTotalNodeNum();
+    chg->classToDFSOrder.assign(numOfClasses, 0);
+    chg->dfsOrderToClass.clear();
+    chg->classClosure.assign(numOfClasses, NodeBS());
+    chg->classToCHAVtbls.assign(numOfClasses, VTableSet());
+    chg->classToCHAVtblsBuilt.assign(numOfClasses, false);
+    chg->classToCHAVFnTable.assign(numOfClasses, std::vector<CHGraph::VFnTableEntry>());
+
+    /// DFS from the classes without base classes first, then from the remaining ones (in cycles)
+    std::vector<const CHNode*> postOrder;
+    std::vector<bool> visited(numOfClasses, false);
+    std::vector<const CHNode*> roots;
+    for (CHGraph::const_iterator it = chg->begin(), eit = chg->end(); it != eit; ++it)
+    {
+        if (it->second->getOutEdges().empty())
+            roots.push_back(it->second);
+    }
+    for (CHGraph::const_iterator it = chg->begin(), eit = chg->end(); it != eit; ++it)
+        roots.push_back(it->second);
 
-    for (CHGraph::const_iterator it = chg->begin(), eit = chg->end();
-            it != eit; ++it)
+    for (const CHNode* root : roots)
     {
-        const CHNode *node = it->second;
-        WorkList worklist;
-        CHNodeSetTy visitedNodes;
-        worklist.push(node);
-        while (!worklist.empty())
+        if (visited[root->getId()])
+            continue;
+        /// iterative DFS over incoming edges, i.e., from a class to its derived classes (or instances)
+        std::vector<std::pair<const CHNode*, CHEdge::CHEdgeSetTy::const_iterator>> dfsStack;
+        visited[root->getId()] = true;
+        chg->classToDFSOrder[root->getId()] = chg->dfsOrderToClass.size();
+        chg->dfsOrderToClass.push_back(root);
+        dfsStack.push_back(std::make_pair(root, root->InEdgeBegin()));
+        while (!dfsStack.empty())
         {
-            const CHNode *curnode = worklist.pop();
-            if (visitedNodes.find(curnode) == visitedNodes.end())
+            const CHNode* node = dfsStack.back().first;
+            CHEdge::CHEdgeSetTy::const_iterator& eit = dfsStack.back().second;
+            if (eit == node->InEdgeEnd())
             {
-                for (CHEdge::CHEdgeSetTy::const_iterator it =
-                            curnode->getOutEdges().begin(), eit =
-                            curnode->getOutEdges().end(); it != eit; ++it)
-                {
-                    if ((*it)->getEdgeType() == CHEdge::INHERITANCE)
-                    {
-                        CHNode *succnode = (*it)->getDstNode();
-                        chg->classNameToAncestorsMap[node->getName()].insert(succnode);
-                        chg->classNameToDescendantsMap[succnode->getName()].insert(node);
-                        worklist.push(succnode);
-                    }
-                }
-                visitedNodes.insert(curnode);
+                postOrder.push_back(node);
+                dfsStack.pop_back();
+                continue;
             }
+            const CHNode* child = (*eit)->getSrcNode();
+            ++eit;
+            if (visited[child->getId()])
+                continue;
+            visited[child->getId()] = true;
+            chg->classToDFSOrder[child->getId()] = chg->dfsOrderToClass.size();
+            chg->dfsOrderToClass.push_back(child);
+            dfsStack.push_back(std::make_pair(child, child->InEdgeBegin()));
         }
     }
-}
-
-
-const CHGraph::CHNodeSetTy& CHGBuilder::getInstancesAndDescendants(const string className)
-{
 
-    CHGraph::NameToCHNodesMap::const_iterator it = chg->classNameToInstAndDescsMap.find(className);
-    if (it != chg->classNameToInstAndDescsMap.end())
+    /// descendants: derived classes come before their base classes in post order,
+    /// more passes are only needed if there are cycles
+    std::vector<NodeBS> descendants(numOfClasses);
+    bool changed = true;
+    while (changed)
     {
-        return it->second;
+        changed = false;
+        for (const CHNode* node : postOrder)
+        {
+            NodeBS& desc = descendants[node->getId()];
+            for (CHEdge::CHEdgeSetTy::const_iterator it = node->InEdgeBegin(), eit = node->InEdgeEnd(); it != eit; ++it)
+            {
+                if ((*it)->getEdgeType() != CHEdge::INHERITANCE)
+                    continue;
+                const CHNode* child = (*it)->getSrcNode();
+                changed |= desc.test_and_set(chg->classToDFSOrder[child->getId()]);
+                changed |= (desc |= descendants[child->getId()]);
+            }
+        }
     }
-    else
+
+    for (const CHNode* node : postOrder)
     {
-        chg->classNameToInstAndDescsMap[className] = chg->getDescendants(className);
-        if (chg->getNode(className)->isTemplate())
+        NodeBS& closure = chg->classClosure[node->getId()];
+        closure.set(chg->classToDFSOrder[node->getId()]);
+        closure |= descendants[node->getId()];
+        if (node->isTemplate())
         {
-            const CHNodeSetTy& instances = chg->getInstances(className);
+            const CHNodeSetTy& instances = chg->getInstances(node->getName());
             for (CHNodeSetTy::const_iterator it = instances.begin(), eit = instances.end(); it != eit; ++it)
             {
-                const CHNode *node = *it;
-                chg->classNameToInstAndDescsMap[className].insert(node);
-                const CHNodeSetTy& instance_descendants = chg->getDescendants(node->getName());
-                for (CHNodeSetTy::const_iterator dit =
-                            instance_descendants.begin(), deit =
-                            instance_descendants.end(); dit != deit; ++dit)
-                {
-                    chg->classNameToInstAndDescsMap[className].insert(*dit);
-                }
+                closure.set(chg->classToDFSOrder[(*it)->getId()]);
+                closure |= descendants[(*it)->getId()];
             }
         }
-        return chg->classNameToInstAndDescsMap[className];
     }
 }
 
-
-
-
 /*
  * do the following things:
  * 1. initialize virtualFunctions for each class
@@ -647,51 +675,21 @@ void CHGBuilder::buildCSToCHAVtblsAndVfnsMap()
         CallSite cs = *it;
         if (!cppUtil::isVirtualCallSite(cs))
             continue;
-        VTableSet vtbls;
-        const CHNodeSetTy& chClasses = getCSClasses(cs);
-        for (CHNodeSetTy::const_iterator it = chClasses.begin(), eit = chClasses.end(); it != eit; ++it)
-        {
-            const CHNode *child = *it;
-            const GlobalValue *vtbl = child->getVTable();
-            if (vtbl != nullptr)
-            {
-                vtbls.insert(vtbl);
-            }
-        }
+        const CHNode* thisNode = chg->getNode(getClassNameOfThisPtr(cs));
+        if (thisNode == nullptr)
+            continue;
+        const VTableSet& vtbls = chg->getCHAVtbls(thisNode);
         if (vtbls.size() > 0)
         {
             chg->csToCHAVtblsMap[cs] = vtbls;
             VFunSet virtualFunctions;
-            chg->getVFnsFromVtbls(cs, vtbls, virtualFunctions);
+            chg->getVFnsFromCHA(cs, thisNode, virtualFunctions);
             if (virtualFunctions.size() > 0)
                 chg->csToCHAVFnsMap[cs] = virtualFunctions;
         }
     }
 }
 
-const CHGraph::CHNodeSetTy& CHGBuilder::getCSClasses(CallSite cs)
-{
-    assert(isVirtualCallSite(cs) && "not virtual callsite!");
-
-    CHGraph::CallSiteToCHNodesMap::const_iterator it = chg->csToClassesMap.find(cs);
-    if (it != chg->csToClassesMap.end())
-    {
-        return it->second;
-    }
-    else
-    {
-        string thisPtrClassName = getClassNameOfThisPtr(cs);
-        if (const CHNode* thisNode = chg->getNode(thisPtrClassName))
-        {
-            const CHGraph::CHNodeSetTy& instAndDesces = getInstancesAndDescendants(thisPtrClassName);
-            chg->csToClassesMap[cs].insert(thisNode);
-            for (CHGraph::CHNodeSetTy::const_iterator it = instAndDesces.begin(), eit = instAndDesces.end(); it != eit; ++it)
-                chg->csToClassesMap[cs].insert(*it);
-        }
-        return chg->csToClassesMap[cs];
-    }
-}
-
 void CHGBuilder::addFuncToFuncVector(CHNode::FuncVector &v, const SVFFunction *f) {
     const auto *lf = f->getLLVMFun();
     if (isCPPThunkFunction(lf)) {
@@ -33,6 +33,7 @@
 
 
 #include <cxxabi.h>   // for demangling
+#include <mutex>
 
 using namespace std;
 using namespace SVF;
@@ -178,21 +179,60 @@ static void handleThunkFunction(cppUtil::DemangledName &dname) {
  * functionName: f<...::...>
  */
 
-struct cppUtil::DemangledName cppUtil::demangle(const string &name)
+/*
+ * Demangled names are cached for the whole process (CHG construction asks for the
+ * same functions again and again), the caches may be used by several threads.
+ */
+static std::mutex demangleCacheMutex;
+static Map<string, cppUtil::DemangledName> demangledNames;
+static Map<string, string> vtblClassNames;
+static Map<const Type*, string> typeClassNames;
+
+/// Constructor and destructor kinds of functions
+enum CtorDtorKind
 {
-    struct cppUtil::DemangledName dname;
-    dname.isThunkFunc = false;
+    NotCtorDtor,
+    CtorKind,
+    DtorKind
+};
+static Map<const Function*, CtorDtorKind> funCtorDtorKinds;
 
+void cppUtil::clearCaches()
+{
+    std::lock_guard<std::mutex> lock(demangleCacheMutex);
+    demangledNames.clear();
+    vtblClassNames.clear();
+    typeClassNames.clear();
+    funCtorDtorKinds.clear();
+}
+
+/// Return the demangled name of a symbol, empty if it cannot be demangled
+static string demangleSymbol(const string &name)
+{
+    string demangled;
     s32_t status;
     char *realname = abi::__cxa_demangle(name.c_str(), 0, 0, &status);
-    if (realname == nullptr)
+    if (realname != nullptr)
+    {
+        demangled = realname;
+        std::free(realname);
+    }
+    return demangled;
+}
+
+static cppUtil::DemangledName computeDemangledName(const string &name)
+{
+    struct cppUtil::DemangledName dname;
+    dname.isThunkFunc = false;
+
+    string realnameStr = demangleSymbol(name);
+    if (realnameStr.empty())
     {
         dname.className = "";
         dname.funcName = "";
     }
     else
     {
-        string realnameStr = string(realname);
         string beforeParenthesis = getBeforeParenthesis(realnameStr);
         if (beforeParenthesis.find("::") == string::npos ||
                 isOperOverload(beforeParenthesis))
@@ -202,7 +242,7 @@ struct cppUtil::DemangledName cppUtil::demangle(const string &name)
         }
         else
         {
-            string beforeBracket = getBeforeBrackets(beforeParenthesis);
+            string beforeBracket = cppUtil::getBeforeBrackets(beforeParenthesis);
             size_t colon = beforeBracket.rfind("::");
             if (colon == string::npos)
             {
@@ -215,7 +255,6 @@ struct cppUtil::DemangledName cppUtil::demangle(const string &name)
                 dname.funcName = beforeParenthesis.substr(colon + 2);
             }
         }
-        std::free(realname);
     }
 
     handleThunkFunction(dname);
@@ -223,6 +262,21 @@ struct cppUtil::DemangledName cppUtil::demangle(const string &name)
     return dname;
 }
 
+struct cppUtil::DemangledName cppUtil::demangle(const string &name)
+{
+    {
+        std::lock_guard<std::mutex> lock(demangleCacheMutex);
+        Map<string, DemangledName>::const_iterator it = demangledNames.find(name);
+        if (it != demangledNames.end())
+            return it->second;
+    }
+
+    DemangledName dname = computeDemangledName(name);
+    std::lock_guard<std::mutex> lock(demangleCacheMutex);
+    demangledNames.emplace(name, dname);
+    return dname;
+}
+
 bool cppUtil::isLoadVtblInst(const LoadInst *loadInst)
 {
     const Value *loadSrc = loadInst->getPointerOperand();
@@ -409,6 +463,13 @@ u64_t cppUtil::getVCallIdx(CallSite cs)
 
 string cppUtil::getClassNameFromType(const Type *ty)
 {
+    {
+        std::lock_guard<std::mutex> lock(demangleCacheMutex);
+        Map<const Type*, string>::const_iterator it = typeClassNames.find(ty);
+        if (it != typeClassNames.end())
+            return it->second;
+    }
+
     string className = "";
     if (const PointerType *ptrType = SVFUtil::dyn_cast<PointerType>(ty))
     {
@@ -427,91 +488,100 @@ string cppUtil::getClassNameFromType(const Type *ty)
             }
         }
     }
+
+    std::lock_guard<std::mutex> lock(demangleCacheMutex);
+    typeClassNames.emplace(ty, className);
     return className;
 }
 
 string cppUtil::getClassNameFromVtblObj(const Value *value)
 {
-    string className = "";
-
     string vtblName = value->getName().str();
-    s32_t status;
-    char *realname = abi::__cxa_demangle(vtblName.c_str(), 0, 0, &status);
-    if (realname != nullptr)
     {
-        string realnameStr = string(realname);
-        if (realnameStr.compare(0, vtblLabelAfterDemangle.size(),
-                                vtblLabelAfterDemangle) == 0)
-        {
-            className = realnameStr.substr(vtblLabelAfterDemangle.size());
-        }
-        std::free(realname);
+        std::lock_guard<std::mutex> lock(demangleCacheMutex);
+        Map<string, string>::const_iterator it = vtblClassNames.find(vtblName);
+        if (it != vtblClassNames.end())
+            return it->second;
+    }
+
+    string className = "";
+    string realnameStr = demangleSymbol(vtblName);
+    if (realnameStr.compare(0, vtblLabelAfterDemangle.size(),
+                            vtblLabelAfterDemangle) == 0)
+    {
+        className = realnameStr.substr(vtblLabelAfterDemangle.size());
     }
+
+    std::lock_guard<std::mutex> lock(demangleCacheMutex);
+    vtblClassNames.emplace(vtblName, className);
     return className;
 }
 
-bool cppUtil::isConstructor(const Function *F)
+/*!
+ * Whether a function is a constructor or a destructor of its class, i.e.,
+ * its (demangled) function name is the class name, or the class name after '~'
+ */
+static CtorDtorKind computeCtorDtorKind(const Function *F)
 {
-    if (F->isDeclaration())
-        return false;
     string funcName = F->getName().str();
     if (funcName.compare(0, vfunPreLabel.size(), vfunPreLabel) != 0)
     {
-        return false;
+        return NotCtorDtor;
     }
-    struct cppUtil::DemangledName dname = demangle(funcName.c_str());
+    struct cppUtil::DemangledName dname = cppUtil::demangle(funcName);
     if (dname.className.size() == 0) {
-        return false;
+        return NotCtorDtor;
     }
-    dname.funcName = getBeforeBrackets(dname.funcName);
-    dname.className = getBeforeBrackets(dname.className);
+    dname.funcName = cppUtil::getBeforeBrackets(dname.funcName);
+    dname.className = cppUtil::getBeforeBrackets(dname.className);
     size_t colon = dname.className.rfind("::");
     if (colon == string::npos)
     {
-        dname.className = getBeforeBrackets(dname.className);
+        dname.className = cppUtil::getBeforeBrackets(dname.className);
     }
     else
     {
-        dname.className = getBeforeBrackets(dname.className.substr(colon+2));
+        dname.className = cppUtil::getBeforeBrackets(dname.className.substr(colon+2));
     }
     if (dname.className.size() > 0 && (dname.className.compare(dname.funcName) == 0))
         /// TODO: on mac os function name is an empty string after demangling
-        return true;
+        return CtorKind;
+    else if (dname.className.size() > 0 && dname.funcName.size() > 0 &&
+            dname.className.size() + 1 == dname.funcName.size() &&
+            dname.funcName.compare(0, 1, "~") == 0 &&
+            dname.className.compare(dname.funcName.substr(1)) == 0)
+        return DtorKind;
     else
-        return false;
+        return NotCtorDtor;
 }
 
-bool cppUtil::isDestructor(const Function *F)
+static CtorDtorKind getCtorDtorKind(const Function *F)
 {
-    if (F->isDeclaration())
-        return false;
-    string funcName = F->getName().str();
-    if (funcName.compare(0, vfunPreLabel.size(), vfunPreLabel) != 0)
     {
-        return false;
+        std::lock_guard<std::mutex> lock(demangleCacheMutex);
+        Map<const Function*, CtorDtorKind>::const_iterator it = funCtorDtorKinds.find(F);
+        if (it != funCtorDtorKinds.end())
+            return it->second;
     }
-    struct cppUtil::DemangledName dname = demangle(funcName.c_str());
-    if (dname.className.size() == 0) {
+
+    CtorDtorKind kind = computeCtorDtorKind(F);
+    std::lock_guard<std::mutex> lock(demangleCacheMutex);
+    funCtorDtorKinds.emplace(F, kind);
+    return kind;
+}
+
+bool cppUtil::isConstructor(const Function *F)
+{
+    if (F->isDeclaration())
         return false;
-    }
-    dname.funcName = getBeforeBrackets(dname.funcName);
-    dname.className = getBeforeBrackets(dname.className);
-    size_t colon = dname.className.rfind("::");
-    if (colon == string::npos)
-    {
-        dname.className = getBeforeBrackets(dname.className);
-    }
-    else
-    {
-        dname.className = getBeforeBrackets(dname.className.substr(colon+2));
-    }
-    if (dname.className.size() > 0 && dname.funcName.size() > 0 &&
-            dname.className.size() + 1 == dname.funcName.size() &&
-            dname.funcName.compare(0, 1, "~") == 0 &&
-            dname.className.compare(dname.funcName.substr(1)) == 0)
-        return true;
-    else
+    return getCtorDtorKind(F) == CtorKind;
+}
+
+bool cppUtil::isDestructor(const Function *F)
+{
+    if (F->isDeclaration())
         return false;
+    return getCtorDtorKind(F) == DtorKind;
 }
 
 string cppUtil::getClassNameOfThisPtr(CallSite cs)
@@ -7,13 +7,16 @@
  *      Author: Mohamad Barbar
  */
 
+#include <atomic>
 #include <sstream>
+#include <thread>
 
 #include "Util/Options.h"
 #include "SVF-FE/DCHG.h"
 #include "SVF-FE/CPPUtil.h"
 #include "Util/SVFUtil.h"
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/IR/DebugInfo.h"
 
 using namespace SVF;
@@ -30,7 +33,6 @@ void DCHGraph::handleDICompositeType(const DICompositeType *compositeType)
     {
     case dwarf::DW_TAG_array_type:
         if (extended) getOrCreateNode(compositeType);
-        gatherAggs(compositeType);
         break;
     case dwarf::DW_TAG_class_type:
     case dwarf::DW_TAG_structure_type:
@@ -63,9 +65,6 @@ void DCHGraph::handleDICompositeType(const DICompositeType *compositeType)
             }
         }
 
-        flatten(compositeType);
-        gatherAggs(compositeType);
-
         break;
     case dwarf::DW_TAG_union_type:
         getOrCreateNode(compositeType);
@@ -82,9 +81,6 @@ void DCHGraph::handleDICompositeType(const DICompositeType *compositeType)
             }
         }
 
-        // flatten(compositeType);
-        gatherAggs(compositeType);
-
         break;
     case dwarf::DW_TAG_enumeration_type:
         getOrCreateNode(compositeType);
@@ -262,141 +258,202 @@ const NodeBS &DCHGraph::cha(const DIType *type, bool firstField)
     return cacheMap[type];
 }
 
-void DCHGraph::flatten(const DICompositeType *type)
+bool DCHGraph::isAgg(const DIType *t)
+{
+    if (t == nullptr) return false;
+    return    t->getTag() == dwarf::DW_TAG_array_type
+              || t->getTag() == dwarf::DW_TAG_structure_type
+              || t->getTag() == dwarf::DW_TAG_class_type;
+}
+
+void DCHGraph::collectAggInfo(const DICompositeType *type, AggInfoMap &aggInfos, std::vector<const DIType *> &order)
 {
-    type = SVFUtil::dyn_cast<DICompositeType>(getCanonicalType(type));
-    assert(type && "DCHG::flatten: canon type of struct/class is not struct/class");
-    if (fieldTypes.find(type) != fieldTypes.end())
+    const DIType *canonType = getCanonicalType(type);
+    if (containingAggs.find(canonType) != containingAggs.end() || aggInfos.find(canonType) != aggInfos.end())
     {
-        // Already done (necessary because of the recursion).
+        // Already done, by an earlier build or because of the recursion.
         return;
     }
 
-    // Create empty vector.
-    fieldTypes[type];
+    // Records a part (which is then collected first) and raises the level above it.
+    // A part still being collected is only reachable through itself and is skipped.
+    auto addPart = [&](const DICompositeType *part) -> bool
+    {
+        collectAggInfo(part, aggInfos, order);
+        const DIType *canonPart = getCanonicalType(part);
+        AggInfoMap::const_iterator it = aggInfos.find(canonPart);
+        if (it == aggInfos.end())
+        {
+            // Done by an earlier build.
+            return true;
+        }
+        if (!it->second.collected) return false;
+        AggInfo &info = aggInfos[canonType];
+        info.level = std::max(info.level, it->second.level + 1);
+        return true;
+    };
 
-    assert(type != nullptr
-           && (type->getTag() == dwarf::DW_TAG_class_type
-               || type->getTag() == dwarf::DW_TAG_structure_type)
-           && "DCHG::flatten: expected a class/struct");
+    aggInfos[canonType];
 
-    // Sort the fields from getElements. Especially a problem for classes; it's all jumbled up.
-    std::vector<const DIDerivedType *> fields;
-    DINodeArray fieldsDINA = type->getElements();
-    for (unsigned i = 0; i < fieldsDINA.size(); ++i)
+    // Aggregates directly contained: the element type of arrays, the member types of the others.
+    std::vector<const DIType *> aggs;
+    if (type->getTag() == dwarf::DW_TAG_array_type)
     {
-        if (const DIDerivedType *dt = SVFUtil::dyn_cast<DIDerivedType>(fieldsDINA[i]))
+        const DIType *bt = stripQualifiers(type->getBaseType());
+        if (isAgg(bt) && addPart(SVFUtil::dyn_cast<DICompositeType>(bt)))
         {
-            // Don't care about subprograms, only member/inheritance.
-            fields.push_back(dt);
+            aggs.push_back(getCanonicalType(bt));
+        }
+    }
+    else
+    {
+        DINodeArray fields = type->getElements();
+        for (unsigned i = 0; i < fields.size(); ++i)
+        {
+            // Unwrap the member (could be a subprogram, not type, so guard needed).
+            if (const DIDerivedType *mt = SVFUtil::dyn_cast<DIDerivedType>(fields[i]))
+            {
+                const DIType *ft = stripQualifiers(mt->getBaseType());
+                if (isAgg(ft) && addPart(SVFUtil::dyn_cast<DICompositeType>(ft)))
+                {
+                    aggs.push_back(getCanonicalType(ft));
+                }
+            }
         }
     }
 
-    // TODO: virtual inheritance is not handled at all!
-    std::sort(fields.begin(), fields.end(),
-              [](const DIDerivedType *&a, const DIDerivedType *&b) -> bool
-    { return a->getOffsetInBits() < b->getOffsetInBits(); });
-
-    for (const DIDerivedType *mt : fields)
+    // Fields of classes/structs; class/struct fields (or arrays thereof) are flattened in turn.
+    std::vector<std::pair<const DIType *, bool>> flatFields;
+    if (type->getTag() == dwarf::DW_TAG_class_type || type->getTag() == dwarf::DW_TAG_structure_type)
     {
-        assert((mt->getTag() == dwarf::DW_TAG_member || mt->getTag() == dwarf::DW_TAG_inheritance)
-               && "DCHG: expected member/inheritance");
-        // Either we have a class, struct, array, or something not in need of flattening.
-        const DIType *fieldType = mt->getBaseType();
-        if (fieldType->getTag() == dwarf::DW_TAG_structure_type
-                || fieldType->getTag() == dwarf::DW_TAG_class_type)
-        {
-            flatten(SVFUtil::dyn_cast<DICompositeType>(fieldType));
-            for (const DIType *ft : fieldTypes[fieldType])
+        const DICompositeType *canonComp = SVFUtil::dyn_cast<DICompositeType>(canonType);
+        assert(canonComp && "DCHG::flatten: canon type of struct/class is not struct/class");
+
+        // Sort the fields from getElements. Especially a problem for classes; it's all jumbled up.
+        std::vector<const DIDerivedType *> fields;
+        DINodeArray fieldsDINA = canonComp->getElements();
+        for (unsigned i = 0; i < fieldsDINA.size(); ++i)
+        {
+            if (const DIDerivedType *dt = SVFUtil::dyn_cast<DIDerivedType>(fieldsDINA[i]))
             {
-                // ft is already a canonical type because the "root" additions insert
-                // canonical types.
-                fieldTypes[type].push_back(ft);
+                // Don't care about subprograms, only member/inheritance.
+                fields.push_back(dt);
             }
         }
-        else if (fieldType->getTag() == dwarf::DW_TAG_array_type)
+
+        // TODO: virtual inheritance is not handled at all!
+        std::stable_sort(fields.begin(), fields.end(),
+                         [](const DIDerivedType *a, const DIDerivedType *b) -> bool
+        { return a->getOffsetInBits() < b->getOffsetInBits(); });
+
+        for (const DIDerivedType *mt : fields)
         {
-            const DICompositeType *arrayType = SVFUtil::dyn_cast<DICompositeType>(fieldType);
-            const DIType *baseType = arrayType->getBaseType();
-            if (const DICompositeType *cbt = SVFUtil::dyn_cast<DICompositeType>(baseType))
+            assert((mt->getTag() == dwarf::DW_TAG_member || mt->getTag() == dwarf::DW_TAG_inheritance)
+                   && "DCHG: expected member/inheritance");
+            // Either we have a class, struct, array, or something not in need of flattening.
+            const DIType *fieldType = mt->getBaseType();
+            if (fieldType != nullptr && fieldType->getTag() == dwarf::DW_TAG_array_type)
+            {
+                fieldType = SVFUtil::dyn_cast<DICompositeType>(fieldType)->getBaseType();
+            }
+
+            if (fieldType != nullptr
+                    && (fieldType->getTag() == dwarf::DW_TAG_structure_type
+                        || fieldType->getTag() == dwarf::DW_TAG_class_type))
             {
-                flatten(cbt);
-                for (const DIType *ft : fieldTypes[cbt])
+                if (addPart(SVFUtil::dyn_cast<DICompositeType>(fieldType)))
                 {
-                    // ft is already a canonical type like above.
-                    fieldTypes[type].push_back(ft);
+                    flatFields.push_back({getCanonicalType(fieldType), true});
                 }
             }
             else
             {
-                fieldTypes[type].push_back(getCanonicalType(baseType));
+                flatFields.push_back({getCanonicalType(fieldType), false});
             }
         }
-        else
-        {
-            fieldTypes[type].push_back(getCanonicalType(fieldType));
-        }
     }
-}
 
-bool DCHGraph::isAgg(const DIType *t)
-{
-    if (t == nullptr) return false;
-    return    t->getTag() == dwarf::DW_TAG_array_type
-              || t->getTag() == dwarf::DW_TAG_structure_type
-              || t->getTag() == dwarf::DW_TAG_class_type;
+    AggInfo &info = aggInfos[canonType];
+    info.aggs = std::move(aggs);
+    info.fields = std::move(flatFields);
+    info.collected = true;
+    order.push_back(canonType);
 }
 
-void DCHGraph::gatherAggs(const DICompositeType *type)
+/*!
+ * Flatten the classes/structs and gather the aggregates contained in the given types.
+ * What each aggregate is directly made of is collected first (canonicalising all the types
+ * involved, which is not thread-safe). The aggregates are then put together level by level,
+ * so that the parts of an aggregate are complete when it is handled; the threads only read
+ * the results of lower levels and write into the entries of their own types, created up front.
+ */
+void DCHGraph::flattenAndGatherAggs(const std::vector<const DICompositeType *> &types)
 {
-    if (containingAggs.find(getCanonicalType(type)) != containingAggs.end())
+    AggInfoMap aggInfos;
+    std::vector<const DIType *> order;
+    for (const DICompositeType *type : types)
     {
-        return;
+        collectAggInfo(type, aggInfos, order);
     }
 
-    // Initialise an empty set. We want all aggregates to have a value in
-    // this map, even if empty (e.g. struct has no aggs, only scalars).
-    containingAggs[getCanonicalType(type)];
-
-    if (type->getTag() == dwarf::DW_TAG_array_type)
+    std::vector<std::vector<const DIType *>> levels;
+    for (const DIType *type : order)
     {
-        const DIType *bt = type->getBaseType();
-        bt = stripQualifiers(bt);
+        const AggInfo &info = aggInfos[type];
+        if (levels.size() <= info.level) levels.resize(info.level + 1);
+        levels[info.level].push_back(type);
 
-        if (isAgg(bt))
+        containingAggs[type];
+        if (type->getTag() == dwarf::DW_TAG_class_type || type->getTag() == dwarf::DW_TAG_structure_type)
         {
-            const DICompositeType *cbt = SVFUtil::dyn_cast<DICompositeType>(bt);
-            containingAggs[getCanonicalType(type)].insert(getCanonicalType(cbt));
-            gatherAggs(cbt);
-            // These must be canonical already because of aggs.insert above/below.
-            containingAggs[getCanonicalType(type)].insert(
-                containingAggs[getCanonicalType(cbt)].begin(),
-                containingAggs[getCanonicalType(cbt)].end());
+            fieldTypes[type];
         }
     }
-    else
+
+    const u32_t numThreads = std::max(1u, static_cast<u32_t>(Options::DCHGThreads));
+    for (const std::vector<const DIType *> &level : levels)
     {
-        DINodeArray fields = type->getElements();
-        for (unsigned i = 0; i < fields.size(); ++i)
+        std::atomic<u32_t> nextType(0);
+        auto build = [&]()
         {
-            // Unwrap the member (could be a subprogram, not type, so guard needed).
-            if (const DIDerivedType *mt = SVFUtil::dyn_cast<DIDerivedType>(fields[i]))
+            for (u32_t i = nextType++; i < level.size(); i = nextType++)
             {
-                const DIType *ft = mt->getBaseType();
-                ft = stripQualifiers(ft);
+                const DIType *type = level[i];
+                const AggInfo &info = aggInfos.at(type);
+
+                Set<const DIType *> &aggs = containingAggs.at(type);
+                for (const DIType *agg : info.aggs)
+                {
+                    // These must be canonical already because of the aggs inserted in collectAggInfo.
+                    const Set<const DIType *> &partAggs = containingAggs.at(agg);
+                    aggs.insert(agg);
+                    aggs.insert(partAggs.begin(), partAggs.end());
+                }
 
-                if (isAgg(ft))
+                if (info.fields.empty()) continue;
+                std::vector<const DIType *> &fields = fieldTypes.at(type);
+                for (const std::pair<const DIType *, bool> &field : info.fields)
                 {
-                    const DICompositeType *cft = SVFUtil::dyn_cast<DICompositeType>(ft);
-                    containingAggs[getCanonicalType(type)].insert(getCanonicalType(cft));
-                    gatherAggs(cft);
-                    // These must be canonical already because of aggs.insert above.
-                    containingAggs[getCanonicalType(type)].insert(
-                        containingAggs[getCanonicalType(cft)].begin(),
-                        containingAggs[getCanonicalType(cft)].end());
+                    if (field.second)
+                    {
+                        // Already canonical because only canonical types are pushed as leaves.
+                        const std::vector<const DIType *> &partFields = fieldTypes.at(field.first);
+                        fields.insert(fields.end(), partFields.begin(), partFields.end());
+                    }
+                    else
+                    {
+                        fields.push_back(field.first);
+                    }
                 }
             }
-        }
+        };
+
+        std::vector<std::thread> workers;
+        for (u32_t t = 1; t < std::min<u32_t>(numThreads, level.size()); ++t)
+            workers.emplace_back(build);
+        build();
+        for (std::thread &worker : workers)
+            worker.join();
     }
 }
 
@@ -477,6 +534,7 @@ void DCHGraph::buildCHG(bool extend)
      */
 
 
+    std::vector<const DICompositeType *> aggs;
     for (const DIType *type : finder.types())
     {
         if (const DIBasicType *basicType = SVFUtil::dyn_cast<DIBasicType>(type))
@@ -492,6 +550,10 @@ void DCHGraph::buildCHG(bool extend)
         else if (const DICompositeType *compositeType = SVFUtil::dyn_cast<DICompositeType>(type))
         {
             handleDICompositeType(compositeType);
+            if (isAgg(compositeType) || compositeType->getTag() == dwarf::DW_TAG_union_type)
+            {
+                aggs.push_back(compositeType);
+            }
         }
         else if (const DIDerivedType *derivedType = SVFUtil::dyn_cast<DIDerivedType>(type))
         {
@@ -507,6 +569,8 @@ void DCHGraph::buildCHG(bool extend)
         }
     }
 
+    flattenAndGatherAggs(aggs);
+
     for (u32_t i = 0; i < LLVMModuleSet::getLLVMModuleSet()->getModuleNum(); ++i)
     {
         buildVTables(*(LLVMModuleSet::getLLVMModuleSet()->getModule(i)));
@@ -733,8 +797,10 @@ const DIType *DCHGraph::getCanonicalType(const DIType *t)
         }
     }
 
-    // Canonical type for t is not cached, find one for it.
-    for (const DIType *canonType : canonicalTypes)
+    // Canonical type for t is not cached, find one for it. Only the canonical types
+    // with the same structural hash can be equivalent to it.
+    std::vector<const DIType *> &bucket = canonicalTypeBuckets[hashDIType(t)];
+    for (const DIType *canonType : bucket)
     {
         if (teq(t, canonType))
         {
@@ -745,6 +811,7 @@ const DIType *DCHGraph::getCanonicalType(const DIType *t)
     }
 
     // No canonical type found, so t will be a canonical type.
+    bucket.push_back(t);
     canonicalTypes.insert(t);
     canonicalTypeMap.insert({t, t});
 
@@ -928,6 +995,63 @@ bool DCHGraph::teq(const DIType *t1, const DIType *t2)
     return false;
 }
 
+size_t DCHGraph::hashDIType(const DIType *t)
+{
+    // Must stay consistent with teq: whatever teq considers equal hashes the same.
+    t = stripQualifiers(t);
+    if (t == nullptr)
+    {
+        return 0;
+    }
+
+    if (const DIBasicType *b = SVFUtil::dyn_cast<DIBasicType>(t))
+    {
+        // Integers, floats, and chars, ignoring signedness.
+        unsigned enc = b->getEncoding();
+        unsigned encClass;
+        if (enc == dwarf::DW_ATE_signed || enc == dwarf::DW_ATE_unsigned || enc == dwarf::DW_ATE_boolean)
+            encClass = 1;
+        else if (enc == dwarf::DW_ATE_float)
+            encClass = 2;
+        else if (enc == dwarf::DW_ATE_signed_char || enc == dwarf::DW_ATE_unsigned_char)
+            encClass = 3;
+        else
+            // Only equal to itself.
+            return llvm::hash_value(t);
+
+        return llvm::hash_combine(encClass, b->getSizeInBits(), b->getAlignInBits());
+    }
+
+    // Pointers, references, arrays, and members are equal when their base types are.
+    if (const DIDerivedType *d = SVFUtil::dyn_cast<DIDerivedType>(t))
+    {
+        return llvm::hash_combine(dwarf::DW_TAG_pointer_type, hashDIType(d->getBaseType()));
+    }
+
+    if (const DICompositeType *c = SVFUtil::dyn_cast<DICompositeType>(t))
+    {
+        if (c->getTag() == dwarf::DW_TAG_array_type)
+        {
+            return llvm::hash_combine(dwarf::DW_TAG_pointer_type, hashDIType(c->getBaseType()));
+        }
+
+        if (c->getTag() == dwarf::DW_TAG_enumeration_type)
+        {
+            return llvm::hash_value(c->getTag());
+        }
+
+        if (c->getTag() == dwarf::DW_TAG_class_type)
+        {
+            return llvm::hash_combine(c->getTag(), c->getIdentifier());
+        }
+
+        return llvm::hash_combine(c->getTag(), c->getName(), c->getFile(), c->getLine());
+    }
+
+    // Subroutine types are only equal to themselves.
+    return llvm::hash_value(t);
+}
+
 bool DCHGraph::isFirstField(const DIType *f, const DIType *b)
 {
     // TODO: some improvements.
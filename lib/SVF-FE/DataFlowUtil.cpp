@@ -30,6 +30,8 @@
 
 #include "SVF-FE/DataFlowUtil.h"
 #include "SVF-FE/LLVMModule.h"
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace llvm;
@@ -121,6 +123,50 @@ DominatorTree* PTACFInfoBuilder::getDT(const Function* f)
         return it->second;
 }
 
+/*!
+ * Compute dominator trees, post dominator trees and loop info of functions.
+ * Each function is analysed independently by a worker, results are added to the maps afterwards.
+ */
+void PTACFInfoBuilder::buildCFInfo(const std::vector<const Function*>& funs, u32_t numOfThreads)
+{
+    std::vector<const Function*> todo;
+    for(const Function* fun : funs)
+    {
+        if(!fun->isDeclaration() && funToLoopInfoMap.find(fun)==funToLoopInfoMap.end())
+            todo.push_back(fun);
+    }
+
+    std::vector<DominatorTree*> dts(todo.size(), nullptr);
+    std::vector<PostDominatorTree*> pdts(todo.size(), nullptr);
+    std::vector<LoopInfo*> loopInfos(todo.size(), nullptr);
+    std::atomic<u32_t> next(0);
+    auto worker = [&]()
+    {
+        for(u32_t i = next++; i < todo.size(); i = next++)
+        {
+            Function* fun = const_cast<Function*>(todo[i]);
+            dts[i] = new DominatorTree(*fun);
+            pdts[i] = new PostDominatorTree(*fun);
+            loopInfos[i] = new LoopInfo(*dts[i]);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(u32_t i = 1; i < numOfThreads && i < todo.size(); ++i)
+        workers.push_back(std::thread(worker));
+    worker();
+    for(std::thread& t : workers)
+        t.join();
+
+    for(u32_t i = 0; i < todo.size(); ++i)
+    {
+        funToLoopInfoMap[todo[i]] = loopInfos[i];
+        if(!funToDTMap.emplace(todo[i], dts[i]).second)
+            delete dts[i];
+        if(!funToPDTMap.emplace(todo[i], pdts[i]).second)
+            delete pdts[i];
+    }
+}
 
 void IteratedDominanceFrontier::calculate(BasicBlock * bb,
         const DominanceFrontier &DF)
@@ -31,6 +31,10 @@
 #include "SVF-FE/LLVMUtil.h"
 #include "SVF-FE/ICFGBuilder.h"
 #include "MemoryModel/SVFIR.h"
+#include "Util/Options.h"
+
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -40,120 +44,243 @@ using namespace SVFUtil;
  */
 void ICFGBuilder::build(SVFModule* svfModule)
 {
+    std::vector<const SVFFunction*> funs;
     for (SVFModule::const_iterator iter = svfModule->begin(), eiter = svfModule->end(); iter != eiter; ++iter)
     {
         const SVFFunction *fun = *iter;
         if (SVFUtil::isExtCall(fun))
             continue;
-        WorkList worklist;
-        processFunEntry(fun,worklist);
-        processFunBody(worklist);
-        processFunExit(fun);
+        funs.push_back(fun);
     }
+
+    u32_t numThreads = std::max(1u, std::min<u32_t>(Options::ICFGBuildThreads, funs.size()));
+    buildFunICFGs(funs, numThreads);
     connectGlobalToProgEntry(svfModule);
 }
 
 /*!
- * function entry
+ * Build the ICFG of functions on numThreads threads (the calling thread alone if numThreads is 1).
+ * The nodes and edges of each function are collected on their own first. The ids of the nodes are
+ * then allocated function by function in module order (entry and exit nodes first), so that they do
+ * not depend on the number of threads. The nodes and intra-procedural edges of a function only involve
+ * this function, hence are created on the threads as well; the nodes are then added to the ICFG and the
+ * inter-procedural edges are created serially.
+ */
+void ICFGBuilder::buildFunICFGs(const std::vector<const SVFFunction*>& funs, u32_t numThreads)
+{
+    PendingFunICFGList pendings(funs.size());
+    std::atomic<u32_t> nextFun(0);
+    auto collect = [&]()
+    {
+        for (u32_t i = nextFun++; i < funs.size(); i = nextFun++)
+            collectFunICFG(funs[i], pendings[i]);
+    };
+
+    std::vector<std::thread> workers;
+    for (u32_t t = 1; t < numThreads; ++t)
+        workers.emplace_back(collect);
+    collect();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    std::vector<NodeID> firstIDs(funs.size());
+    for (u32_t i = 0; i < funs.size(); ++i)
+    {
+        icfg->getFunEntryBlockNode(funs[i]);
+        icfg->getFunExitBlockNode(funs[i]);
+        firstIDs[i] = icfg->totalICFGNode;
+        icfg->totalICFGNode += pendings[i].nodes.size();
+    }
+
+    std::vector<std::vector<ICFGNode*>> funNodes(funs.size());
+    nextFun = 0;
+    auto create = [&]()
+    {
+        for (u32_t i = nextFun++; i < funs.size(); i = nextFun++)
+            createFunICFG(funs[i], pendings[i], firstIDs[i], funNodes[i]);
+    };
+
+    workers.clear();
+    for (u32_t t = 1; t < numThreads; ++t)
+        workers.emplace_back(create);
+    create();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    for (const std::vector<ICFGNode*>& nodes : funNodes)
+    {
+        for (ICFGNode* node : nodes)
+            icfg->addBlockICFGNode(node);
+    }
+
+    for (const PendingFunICFG& pending : pendings)
+    {
+        for (const Instruction* cs : pending.callSites)
+        {
+            if (const SVFFunction* callee = getCallee(cs))
+                addICFGInterEdges(cs, callee);
+        }
+    }
+}
+
+/*!
+ * Collect the nodes and edges of a function: those from the function entry,
+ * those of the function body in worklist order, and those to the function exit
+ * (e.g., exit(0), which manifests as an "unreachable" instruction after UnifyFunctionExitNodes)
  */
-void ICFGBuilder::processFunEntry(const SVFFunction*  fun, WorkList& worklist)
+void ICFGBuilder::collectFunICFG(const SVFFunction* fun, PendingFunICFG& pending) const
 {
-    FunEntryBlockNode* FunEntryBlockNode = icfg->getFunEntryBlockNode(fun);
+    /// function entry
+    WorkList worklist;
     const Instruction* entryInst = &((fun->getLLVMFun()->getEntryBlock()).front());
     InstVec insts;
     if (isIntrinsicInst(entryInst))
         getNextInsts(entryInst, insts);
     else
         insts.push_back(entryInst);
-    for (InstVec::const_iterator nit = insts.begin(), enit = insts.end();
-            nit != enit; ++nit)
+    for (const Instruction* inst : insts)
     {
-        ICFGNode* instNode = getOrAddBlockICFGNode(*nit);           //add interprocedure edge
-        icfg->addIntraEdge(FunEntryBlockNode, instNode);
-        worklist.push(*nit);
+        u32_t instNode = getOrAddPendingBlockNode(inst, pending);
+        pending.edges.push_back({PendingFunICFG::FunEntryIdx, instNode, nullptr, 0});
+        worklist.push(inst);
     }
-}
 
-/*!
- * function body
- */
-void ICFGBuilder::processFunBody(WorkList& worklist)
-{
-    BBSet visited;
     /// function body
+    BBSet visited;
     while (!worklist.empty())
     {
         const Instruction* inst = worklist.pop();
-        if (visited.find(inst) == visited.end())
+        if (!visited.insert(inst).second)
+            continue;
+
+        u32_t srcNode = getOrAddPendingBlockNode(inst, pending);
+        if (isReturn(inst))
+            pending.edges.push_back({srcNode, PendingFunICFG::FunExitIdx, nullptr, 0});
+        InstVec nextInsts;
+        getNextInsts(inst, nextInsts);
+        NodeID branchID = 0;
+        for (const Instruction* succ : nextInsts)
         {
-            visited.insert(inst);
-            ICFGNode* srcNode = getOrAddBlockICFGNode(inst);
-            if (isReturn(inst))
-            {
-                const Function* fun = inst->getFunction();
-                const SVFFunction* svfFun = LLVMModuleSet::getLLVMModuleSet()->getSVFFunction(fun);
-                FunExitBlockNode* FunExitBlockNode = icfg->getFunExitBlockNode(svfFun);
-                icfg->addIntraEdge(srcNode, FunExitBlockNode);
-            }
-            InstVec nextInsts;
-            getNextInsts(inst, nextInsts);
-            NodeID branchID = 0;
-            for (InstVec::const_iterator nit = nextInsts.begin(), enit =
-                        nextInsts.end(); nit != enit; ++nit)
+            u32_t dstNode = getOrAddPendingBlockNode(succ, pending);
+            if (isNonInstricCallSite(inst))
             {
-                const Instruction* succ = *nit;
-                ICFGNode* dstNode = getOrAddBlockICFGNode(succ);
-                if (isNonInstricCallSite(inst))
-                {
-                    RetBlockNode* retICFGNode = getOrAddRetICFGNode(inst);
-                    icfg->addIntraEdge(srcNode, retICFGNode);
-                    srcNode = retICFGNode;
-                }
-
-                
-                if (const BranchInst* br = SVFUtil::dyn_cast<BranchInst>(inst))
-                {
-                    if(br->isConditional())
-                        icfg->addConditionalIntraEdge(srcNode, dstNode, br->getCondition(), branchID);
-                    else 
-                        icfg->addIntraEdge(srcNode, dstNode);
-                }
-
-                if (const SwitchInst* si = SVFUtil::dyn_cast<SwitchInst>(inst))
-                {
-                    icfg->addConditionalIntraEdge(srcNode, dstNode, si->getCondition(),branchID);
-                }
-                else
-                    icfg->addIntraEdge(srcNode, dstNode);
-                
-                worklist.push(succ);
-                branchID++;
+                u32_t retNode = getOrAddPendingRetNode(inst, pending);
+                pending.edges.push_back({srcNode, retNode, nullptr, 0});
+                srcNode = retNode;
             }
+
+            // Only the first edge between two nodes is added to the ICFG, so a conditional
+            // edge is not followed by an unconditional one
+            const BranchInst* br = SVFUtil::dyn_cast<BranchInst>(inst);
+            const SwitchInst* si = SVFUtil::dyn_cast<SwitchInst>(inst);
+            if (br && br->isConditional())
+                pending.edges.push_back({srcNode, dstNode, br->getCondition(), branchID});
+            else if (si)
+                pending.edges.push_back({srcNode, dstNode, si->getCondition(), branchID});
+            else
+                pending.edges.push_back({srcNode, dstNode, nullptr, 0});
+
+            worklist.push(succ);
+            branchID++;
         }
     }
-}
-
-/*!
- * function exit e.g., exit(0). In LLVM, it usually manifests as "unreachable" instruction
- * If a function has multiple exit(0), we will only have one "unreachle" instruction
- * after the UnifyFunctionExitNodes pass.
- */
-void ICFGBuilder::processFunExit(const SVFFunction*  fun)
-{
-    FunExitBlockNode* FunExitBlockNode = icfg->getFunExitBlockNode(fun);
 
+    /// function exit
     for (inst_iterator II = inst_begin(fun->getLLVMFun()), EE = inst_end(fun->getLLVMFun()); II != EE; ++II)
     {
         const Instruction *inst = &*II;
-        if(SVFUtil::isa<ReturnInst>(inst)) {
-            ICFGNode* instNode = getOrAddBlockICFGNode(inst);
-            icfg->addIntraEdge(instNode, FunExitBlockNode);
+        if (SVFUtil::isa<ReturnInst>(inst))
+        {
+            u32_t instNode = getOrAddPendingBlockNode(inst, pending);
+            pending.edges.push_back({instNode, PendingFunICFG::FunExitIdx, nullptr, 0});
         }
     }
 }
 
+u32_t ICFGBuilder::getOrAddPendingBlockNode(const Instruction* inst, PendingFunICFG& pending) const
+{
+    Map<const Instruction*, u32_t>::const_iterator it = pending.blockNodes.find(inst);
+    if (it != pending.blockNodes.end())
+        return it->second;
 
+    u32_t idx = pending.nodes.size();
+    if (SVFUtil::isNonInstricCallSite(inst))
+    {
+        pending.nodes.push_back(std::make_pair(inst, ICFGNode::FunCallBlock));
+        pending.callSites.push_back(inst);
+    }
+    else
+    {
+        pending.nodes.push_back(std::make_pair(inst, ICFGNode::IntraBlock));
+    }
+    pending.blockNodes[inst] = idx;
+    return idx;
+}
+
+u32_t ICFGBuilder::getOrAddPendingRetNode(const Instruction* inst, PendingFunICFG& pending) const
+{
+    Map<const Instruction*, u32_t>::const_iterator it = pending.retNodes.find(inst);
+    if (it != pending.retNodes.end())
+        return it->second;
 
+    assert(pending.blockNodes.count(inst) && "call node not collected before its ret node?");
+    u32_t idx = pending.nodes.size();
+    pending.nodes.push_back(std::make_pair(inst, ICFGNode::FunRetBlock));
+    pending.retNodes[inst] = idx;
+    return idx;
+}
+
+/*!
+ * Create the nodes and intra-procedural edges of a function.
+ * Only the nodes of this function (which are not in the ICFG yet) and its entry/exit nodes are touched.
+ */
+void ICFGBuilder::createFunICFG(const SVFFunction* fun, const PendingFunICFG& pending, NodeID firstID, std::vector<ICFGNode*>& nodes) const
+{
+    nodes.reserve(pending.nodes.size());
+    for (u32_t i = 0; i < pending.nodes.size(); ++i)
+    {
+        const Instruction* inst = pending.nodes[i].first;
+        NodeID id = firstID + i;
+        switch (pending.nodes[i].second)
+        {
+        case ICFGNode::IntraBlock:
+            nodes.push_back(new IntraBlockNode(id, inst));
+            break;
+        case ICFGNode::FunCallBlock:
+            nodes.push_back(new CallBlockNode(id, inst));
+            break;
+        case ICFGNode::FunRetBlock:
+        {
+            CallBlockNode* callNode = SVFUtil::cast<CallBlockNode>(nodes[pending.blockNodes.at(inst)]);
+            RetBlockNode* retNode = new RetBlockNode(id, inst, callNode);
+            callNode->setRetBlockNode(retNode);
+            nodes.push_back(retNode);
+            break;
+        }
+        default:
+            assert(false && "not an intra/call/ret node?");
+        }
+    }
+
+    FunEntryBlockNode* entryNode = icfg->getFunEntryBlockNode(fun);
+    FunExitBlockNode* exitNode = icfg->getFunExitBlockNode(fun);
+    auto getNode = [&](u32_t idx) -> ICFGNode*
+    {
+        if (idx == PendingFunICFG::FunEntryIdx)
+            return entryNode;
+        if (idx == PendingFunICFG::FunExitIdx)
+            return exitNode;
+        return nodes[idx];
+    };
+
+    for (const PendingFunICFG::Edge& edge : pending.edges)
+    {
+        if (edge.cond)
+            icfg->addConditionalIntraEdge(getNode(edge.src), getNode(edge.dst), edge.cond, edge.branchID);
+        else
+            icfg->addIntraEdge(getNode(edge.src), getNode(edge.dst));
+    }
+}
 
 /*!
  * (1) Add and get CallBlockICFGNode
@@ -33,6 +33,8 @@
 #include "Util/SVFUtil.h"
 #include "SVF-FE/LLVMUtil.h"
 #include "SVF-FE/BreakConstantExpr.h"
+#include <atomic>
+#include <thread>
 
 using namespace std;
 using namespace SVF;
@@ -178,9 +180,22 @@ void LLVMModuleSet::loadModules(const std::vector<std::string> &moduleNameVec)
     //
     cxts = std::make_unique<LLVMContext>();
 
-    for (const std::string& moduleName : moduleNameVec) {
+    // Reading the files does not touch the context and can be done concurrently,
+    // parsing into the shared context can not.
+    std::vector<std::unique_ptr<MemoryBuffer>> buffers;
+    std::vector<std::string> errors;
+    readModuleFiles(moduleNameVec, buffers, errors);
+
+    for (u32_t i = 0; i < moduleNameVec.size(); ++i) {
+        const std::string& moduleName = moduleNameVec[i];
         SMDiagnostic Err;
-        std::unique_ptr<Module> mod = parseIRFile(moduleName, Err, *cxts);
+        std::unique_ptr<Module> mod;
+        if (buffers[i] == nullptr)
+            Err = SMDiagnostic(moduleName, llvm::SourceMgr::DK_Error, "Could not open input file: " + errors[i]);
+        else if (Options::LazyLoad)
+            mod = getLazyIRModule(std::move(buffers[i]), Err, *cxts);
+        else
+            mod = parseIR(buffers[i]->getMemBufferRef(), Err, *cxts);
         if (mod == nullptr)
         {
             SVFUtil::errs() << "load module: " << moduleName << "failed!!\n\n";
@@ -190,6 +205,169 @@ void LLVMModuleSet::loadModules(const std::vector<std::string> &moduleNameVec)
         modules.emplace_back(*mod);
         owned_modules.emplace_back(std::move(mod));
     }
+
+    if (Options::LazyLoad)
+        materializeReachableFunctions();
+}
+
+void LLVMModuleSet::readModuleFiles(const std::vector<std::string> &moduleNameVec, std::vector<std::unique_ptr<MemoryBuffer>> &buffers, std::vector<std::string> &errors)
+{
+    buffers.resize(moduleNameVec.size());
+    errors.resize(moduleNameVec.size());
+
+    u32_t numThreads = std::max(1u, std::min<u32_t>(Options::LoadThreads, moduleNameVec.size()));
+    // With several threads, read the files into memory (volatile) instead of mapping them,
+    // so the I/O is done here rather than page by page while parsing.
+    bool readInMemory = numThreads > 1;
+    std::atomic<u32_t> nextModule(0);
+    auto readFiles = [&]()
+    {
+        for (u32_t i = nextModule++; i < moduleNameVec.size(); i = nextModule++)
+        {
+            llvm::ErrorOr<std::unique_ptr<MemoryBuffer>> buffer = moduleNameVec[i] == "-" ?
+                    MemoryBuffer::getSTDIN() : MemoryBuffer::getFile(moduleNameVec[i], false, true, readInMemory);
+            if (std::error_code EC = buffer.getError())
+                errors[i] = EC.message();
+            else
+                buffers[i] = std::move(buffer.get());
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (u32_t t = 1; t < numThreads; ++t)
+        workers.emplace_back(readFiles);
+    readFiles();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+/*!
+ * Collect the functions a constant refers to, looking through constant expressions and aggregates
+ */
+static void collectReferencedFuns(const Constant* root, std::vector<Function*>& funs, Set<const Constant*>& visited)
+{
+    std::vector<const Constant*> worklist;
+    worklist.push_back(root);
+    while (!worklist.empty())
+    {
+        const Constant* c = worklist.back();
+        worklist.pop_back();
+        if (!visited.insert(c).second)
+            continue;
+        if (const Function* fun = SVFUtil::dyn_cast<Function>(c))
+            funs.push_back(const_cast<Function*>(fun));
+        else if (SVFUtil::isa<GlobalValue>(c))
+            continue;   // initializers of global variables are scanned on their own
+        else
+        {
+            for (const Use& op : c->operands())
+            {
+                if (const Constant* opc = SVFUtil::dyn_cast<Constant>(op.get()))
+                    worklist.push_back(opc);
+            }
+        }
+    }
+}
+
+/*!
+ * Starting from main, the initializers of global variables/aliases (e.g., function pointer
+ * tables, vtables, global ctors) and, transitively, every function referred to by a
+ * materialized body are materialized, looking through declarations to the definitions of
+ * other modules. Bodies which are never reached are dropped, turning them into declarations;
+ * those of functions with local linkage are left out of the declaration-to-definition mapping.
+ * Without a main (e.g., a library) everything is materialized.
+ */
+void LLVMModuleSet::materializeReachableFunctions()
+{
+    Map<std::string, Function*> nameToDef;
+    Function* mainFun = nullptr;
+    for (Module& mod : modules)
+    {
+        for (Function& fun : mod)
+        {
+            /// a definition with local linkage (e.g., static) never resolves a declaration of another module
+            if (fun.isDeclaration() || fun.hasLocalLinkage())
+                continue;
+            nameToDef[fun.getName().str()] = &fun;
+            if (fun.getName() == "main")
+                mainFun = &fun;
+        }
+    }
+
+    if (mainFun == nullptr)
+    {
+        for (Module& mod : modules)
+        {
+            if (llvm::Error err = mod.materializeAll())
+                SVFUtil::errs() << "materialize module " << mod.getModuleIdentifier() << " failed: " << llvm::toString(std::move(err)) << "\n";
+        }
+        return;
+    }
+
+    std::vector<Function*> worklist;
+    Set<const Constant*> visitedConsts;
+    worklist.push_back(mainFun);
+    for (Module& mod : modules)
+    {
+        for (const GlobalVariable& global : mod.globals())
+        {
+            if (global.hasInitializer())
+                collectReferencedFuns(global.getInitializer(), worklist, visitedConsts);
+        }
+        for (const GlobalAlias& alias : mod.aliases())
+            collectReferencedFuns(alias.getAliasee(), worklist, visitedConsts);
+    }
+
+    Set<Function*> reached;
+    while (!worklist.empty())
+    {
+        Function* fun = worklist.back();
+        worklist.pop_back();
+        if (fun->isDeclaration())
+        {
+            Map<std::string, Function*>::const_iterator it = nameToDef.find(fun->getName().str());
+            if (it == nameToDef.end())
+                continue;
+            fun = it->second;
+        }
+        if (!reached.insert(fun).second)
+            continue;
+
+        if (llvm::Error err = fun->materialize())
+        {
+            SVFUtil::errs() << "materialize function " << fun->getName() << " failed: " << llvm::toString(std::move(err)) << "\n";
+            continue;
+        }
+        if (fun->hasPersonalityFn())
+            collectReferencedFuns(fun->getPersonalityFn(), worklist, visitedConsts);
+        for (const BasicBlock& bb : *fun)
+        {
+            for (const Instruction& inst : bb)
+            {
+                for (const Use& op : inst.operands())
+                {
+                    if (const Constant* c = SVFUtil::dyn_cast<Constant>(op.get()))
+                        collectReferencedFuns(c, worklist, visitedConsts);
+                }
+            }
+        }
+    }
+
+    for (Module& mod : modules)
+    {
+        for (Function& fun : mod)
+        {
+            if (fun.isMaterializable())
+            {
+                /// deleteBody makes it an external declaration, which must not resolve to another module's definition
+                if (fun.hasLocalLinkage())
+                    droppedLocalFuns.insert(&fun);
+                fun.deleteBody();
+            }
+        }
+        if (llvm::Error err = mod.materializeMetadata())
+            SVFUtil::errs() << "materialize metadata of " << mod.getModuleIdentifier() << " failed: " << llvm::toString(std::move(err)) << "\n";
+    }
 }
 
 void LLVMModuleSet::initialize()
@@ -302,6 +480,8 @@ void LLVMModuleSet::buildFunToFunMap()
             eit = svfModule->llvmFunEnd(); it != eit; ++it)
     {
         Function *fun = *it;
+        if (droppedLocalFuns.find(fun) != droppedLocalFuns.end())
+            continue;
         if (fun->isDeclaration())
         {
             funDecls.insert(fun);
@@ -34,6 +34,9 @@
 #include "SVF-FE/CPPUtil.h"
 #include "Util/BasicTypes.h"
 #include "MemoryModel/PAGBuilderFromFile.h"
+#include "Util/Options.h"
+#include <atomic>
+#include <thread>
 
 using namespace std;
 using namespace SVF;
@@ -68,58 +71,197 @@ SVFIR* SVFIRBuilder::build(SVFModule* svfModule)
     ///// collect exception vals in the program
 
     /// handle functions
-    for (SVFModule::iterator fit = svfModule->begin(), efit = svfModule->end();
-            fit != efit; ++fit)
+    visitFunctions(svfModule);
+
+    sanityCheck();
+
+    pag->initialiseCandidatePointers();
+
+    pag->setNodeNumAfterPAGBuild(pag->getTotalNodeNum());
+
+    return pag;
+}
+
+/*!
+ * Whether an instruction must be visited by the builder itself when the collected statements
+ * are merged, as its handling may add nodes or edges elsewhere, i.e., the ones using a constant
+ * expression (see processCE), geps (type info is computed lazily), calls and branches
+ */
+static bool needsSerialVisit(Instruction& inst)
+{
+    if (SVFUtil::isa<GetElementPtrInst>(inst) || SVFUtil::isa<CallBase>(inst)
+            || SVFUtil::isa<BranchInst>(inst) || SVFUtil::isa<SwitchInst>(inst))
+        return true;
+    for (const Use& op : inst.operands())
     {
-        const SVFFunction& fun = **fit;
-        /// collect return node of function fun
-        if(!SVFUtil::isExtCall(&fun))
-        {
-            /// Return SVFIR node will not be created for function which can not
-            /// reach the return instruction due to call to abort(), exit(),
-            /// etc. In 176.gcc of SPEC 2000, function build_objc_string() from
-            /// c-lang.c shows an example when fun.doesNotReturn() evaluates
-            /// to TRUE because of abort().
-            if(fun.getLLVMFun()->doesNotReturn() == false && fun.getLLVMFun()->getReturnType()->isVoidTy() == false)
-                pag->addFunRet(&fun,pag->getGNode(pag->getReturnNode(&fun)));
-
-            /// To be noted, we do not record arguments which are in declared function without body
-            /// TODO: what about external functions with SVFIR imported by commandline?
-            for (Function::arg_iterator I = fun.getLLVMFun()->arg_begin(), E = fun.getLLVMFun()->arg_end();
-                    I != E; ++I) {
-                setCurrentLocation(&*I,&fun.getLLVMFun()->getEntryBlock());
-                NodeID argValNodeId = pag->getValueNode(&*I);
-                // if this is the function does not have caller (e.g. main)
-                // or a dead function, shall we create a black hole address edge for it?
-                // it is (1) too conservative, and (2) make FormalParmVFGNode defined at blackhole address PAGEdge.
-                // if(SVFUtil::ArgInNoCallerFunction(&*I)) {
-                //    if(I->getType()->isPointerTy())
-                //        addBlackHoleAddrEdge(argValNodeId);
-                //}
-                pag->addFunArgs(&fun,pag->getGNode(argValNodeId));
-            }
-        }
-        for (Function::iterator bit = fun.getLLVMFun()->begin(), ebit = fun.getLLVMFun()->end();
-                bit != ebit; ++bit)
+        if (SVFUtil::isa<ConstantExpr>(op.get()))
+            return true;
+    }
+    /// visitCastInst looks through the casts of a non-pointer operand
+    if (CastInst* cast = SVFUtil::dyn_cast<CastInst>(&inst))
+    {
+        Value* opnd = cast->getOperand(0);
+        if (!SVFUtil::isa<PointerType>(opnd->getType()) && SVFUtil::isa<ConstantExpr>(stripAllCasts(opnd)))
+            return true;
+    }
+    return false;
+}
+
+/*!
+ * Handle functions.
+ * With -pag-build-threads, worker threads collect the statements of each function into its
+ * own buffer, and the buffers are then merged into SVFIR following the order of the module,
+ * so that nodes and edges are created in the same order as visiting the functions one by one.
+ */
+void SVFIRBuilder::visitFunctions(SVFModule* svfModule)
+{
+    const SVFModule::FunctionSetType funs(svfModule->begin(), svfModule->end());
+    u32_t numThreads = std::max(1u, std::min<u32_t>(Options::PAGBuildThreads, funs.size()));
+
+    if (numThreads == 1)
+    {
+        for (const SVFFunction* fun : funs)
         {
-            BasicBlock& bb = *bit;
-            for (BasicBlock::iterator it = bb.begin(), eit = bb.end();
-                    it != eit; ++it)
+            initialiseFunRetAndArgs(*fun);
+            for (Function::iterator bit = fun->getLLVMFun()->begin(), ebit = fun->getLLVMFun()->end();
+                    bit != ebit; ++bit)
             {
-                Instruction& inst = *it;
-                setCurrentLocation(&inst,&bb);
-                visit(inst);
+                BasicBlock& bb = *bit;
+                for (BasicBlock::iterator it = bb.begin(), eit = bb.end();
+                        it != eit; ++it)
+                {
+                    Instruction& inst = *it;
+                    setCurrentLocation(&inst,&bb);
+                    visit(inst);
+                }
             }
         }
+        return;
     }
 
-    sanityCheck();
+    std::vector<PendingStmtList> pendingStmts(funs.size());
+    std::atomic<u32_t> nextFun(0);
+    auto collect = [&]()
+    {
+        for (u32_t i = nextFun++; i < funs.size(); i = nextFun++)
+            collectPendingStmts(*funs[i], pendingStmts[i]);
+    };
+
+    std::vector<std::thread> workers;
+    for (u32_t t = 1; t < numThreads; ++t)
+        workers.emplace_back(collect);
+    collect();
+    for (std::thread& worker : workers)
+        worker.join();
+
+    for (u32_t i = 0; i < funs.size(); ++i)
+    {
+        initialiseFunRetAndArgs(*funs[i]);
+        mergePendingStmts(pendingStmts[i]);
+        PendingStmtList().swap(pendingStmts[i]);
+    }
+}
 
-    pag->initialiseCandidatePointers();
+/*!
+ * Record the return and the arguments of a function
+ */
+void SVFIRBuilder::initialiseFunRetAndArgs(const SVFFunction& fun)
+{
+    /// collect return node of function fun
+    if(SVFUtil::isExtCall(&fun))
+        return;
 
-    pag->setNodeNumAfterPAGBuild(pag->getTotalNodeNum());
+    /// Return SVFIR node will not be created for function which can not
+    /// reach the return instruction due to call to abort(), exit(),
+    /// etc. In 176.gcc of SPEC 2000, function build_objc_string() from
+    /// c-lang.c shows an example when fun.doesNotReturn() evaluates
+    /// to TRUE because of abort().
+    if(fun.getLLVMFun()->doesNotReturn() == false && fun.getLLVMFun()->getReturnType()->isVoidTy() == false)
+        pag->addFunRet(&fun,pag->getGNode(pag->getReturnNode(&fun)));
+
+    /// To be noted, we do not record arguments which are in declared function without body
+    /// TODO: what about external functions with SVFIR imported by commandline?
+    for (Function::arg_iterator I = fun.getLLVMFun()->arg_begin(), E = fun.getLLVMFun()->arg_end();
+            I != E; ++I) {
+        setCurrentLocation(&*I,&fun.getLLVMFun()->getEntryBlock());
+        NodeID argValNodeId = pag->getValueNode(&*I);
+        // if this is the function does not have caller (e.g. main)
+        // or a dead function, shall we create a black hole address edge for it?
+        // it is (1) too conservative, and (2) make FormalParmVFGNode defined at blackhole address PAGEdge.
+        // if(SVFUtil::ArgInNoCallerFunction(&*I)) {
+        //    if(I->getType()->isPointerTy())
+        //        addBlackHoleAddrEdge(argValNodeId);
+        //}
+        pag->addFunArgs(&fun,pag->getGNode(argValNodeId));
+    }
+}
 
-    return pag;
+/*!
+ * Collect the statements of a function, called by worker threads.
+ * The instructions are visited by a builder of their own which records the statements
+ * instead of adding them to SVFIR, the others are recorded as Visit.
+ */
+void SVFIRBuilder::collectPendingStmts(const SVFFunction& fun, PendingStmtList& stmts) const
+{
+    SVFIRBuilder collector;
+    collector.pendingStmts = &stmts;
+    for (BasicBlock& bb : *fun.getLLVMFun())
+    {
+        for (Instruction& inst : bb)
+        {
+            if (needsSerialVisit(inst))
+            {
+                stmts.push_back(PendingStmt(PendingStmt::Visit, &inst));
+                continue;
+            }
+            collector.setCurrentLocation(&inst, &bb);
+            collector.visit(inst);
+        }
+    }
+}
+
+/*!
+ * Insert the collected statements of a function into SVFIR
+ */
+void SVFIRBuilder::mergePendingStmts(const PendingStmtList& stmts)
+{
+    for (const PendingStmt& stmt : stmts)
+    {
+        setCurrentLocation(stmt.inst, stmt.inst->getParent());
+        switch (stmt.kind)
+        {
+        case PendingStmt::Addr:
+            addAddrEdge(stmt.src, stmt.dst);
+            break;
+        case PendingStmt::Copy:
+            addCopyEdge(stmt.src, stmt.dst);
+            break;
+        case PendingStmt::Phi:
+            addPhiStmt(stmt.dst, stmt.src);
+            break;
+        case PendingStmt::Load:
+            addLoadEdge(stmt.src, stmt.dst);
+            break;
+        case PendingStmt::Store:
+            addStoreEdge(stmt.src, stmt.dst);
+            break;
+        case PendingStmt::BinaryOP:
+            addBinaryOPEdge(stmt.src, stmt.op2, stmt.dst, stmt.opcode);
+            break;
+        case PendingStmt::UnaryOP:
+            addUnaryOPEdge(stmt.src, stmt.dst, stmt.opcode);
+            break;
+        case PendingStmt::Cmp:
+            addCmpEdge(stmt.src, stmt.op2, stmt.dst, stmt.opcode);
+            break;
+        case PendingStmt::BlackHoleAddr:
+            addBlackHoleAddrEdge(stmt.dst);
+            break;
+        case PendingStmt::Visit:
+            visit(*stmt.inst);
+            break;
+        }
+    }
 }
 
 /*
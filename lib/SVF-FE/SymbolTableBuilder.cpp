@@ -37,6 +37,9 @@
 #include "SVF-FE/LLVMUtil.h"
 #include "SVF-FE/CPPUtil.h"
 #include "SVF-FE/GEPTypeBridgeIterator.h" // include bridge_gep_iterator
+#include "llvm/IR/TypeFinder.h"
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -52,6 +55,9 @@ void SymbolTableBuilder::buildMemModel(SVFModule* svfModule)
 
     StInfo::setMaxFieldLimit(Options::MaxFieldLimit);
 
+    if (Options::SymTabThreads > 1)
+        collectStructTypeInfo(Options::SymTabThreads);
+
     // Object #0 is black hole the object that may point to any object
     assert(symInfo->totalSymNum++ == SymbolTableInfo::BlackHole && "Something changed!");
     symInfo->createBlkObj(SymbolTableInfo::BlackHole);
@@ -82,115 +88,196 @@ void SymbolTableBuilder::buildMemModel(SVFModule* svfModule)
     }
 
     // Add symbols for all of the functions and the instructions in them.
-    for (SVFModule::llvm_iterator F = svfModule->llvmFunBegin(), E = svfModule->llvmFunEnd(); F != E; ++F)
+    // With -symtab-threads, the symbols of functions are collected on multiple threads
+    // and then created following the order of the functions, so that the SymIDs are the
+    // same as the ones allocated by visiting the functions one by one.
+    std::vector<Function*> funs(svfModule->llvmFunBegin(), svfModule->llvmFunEnd());
+    u32_t numThreads = std::max(1u, std::min<u32_t>(Options::SymTabThreads, funs.size()));
+    if (numThreads == 1)
     {
-        Function *fun = *F;
-        collectSym(fun);
-        collectRet(fun);
-        if (fun->getFunctionType()->isVarArg())
-            collectVararg(fun);
-
-        // Add symbols for all formal parameters.
-        for (Function::arg_iterator I = fun->arg_begin(), E = fun->arg_end();
-                I != E; ++I)
+        for (Function* fun : funs)
         {
-            collectSym(&*I);
+            FunSyms funSyms;
+            collectFunSyms(fun, funSyms);
+            createFunSyms(fun, funSyms);
         }
-
-        // collect and create symbols inside the function body
-        for (inst_iterator II = inst_begin(*fun), E = inst_end(*fun); II != E; ++II)
+    }
+    else
+    {
+        std::vector<FunSyms> funSyms(funs.size());
+        std::atomic<u32_t> nextFun(0);
+        auto collect = [&]()
         {
-            const Instruction *inst = &*II;
-            collectSym(inst);
+            for (u32_t i = nextFun++; i < funs.size(); i = nextFun++)
+                collectFunSyms(funs[i], funSyms[i]);
+        };
+
+        std::vector<std::thread> workers;
+        for (u32_t t = 1; t < numThreads; ++t)
+            workers.emplace_back(collect);
+        collect();
+        for (std::thread& worker : workers)
+            worker.join();
+
+        for (u32_t i = 0; i < funs.size(); ++i)
+        {
+            createFunSyms(funs[i], funSyms[i]);
+            funSyms[i] = FunSyms();
+        }
+    }
 
-            // initialization for some special instructions
-            //{@
-            if (const StoreInst *st = SVFUtil::dyn_cast<StoreInst>(inst))
-            {
-                collectSym(st->getPointerOperand());
-                collectSym(st->getValueOperand());
-            }
-            else if (const LoadInst *ld = SVFUtil::dyn_cast<LoadInst>(inst))
-            {
-                collectSym(ld->getPointerOperand());
-            }
-            else if (const PHINode *phi = SVFUtil::dyn_cast<PHINode>(inst))
-            {
-                for (u32_t i = 0; i < phi->getNumIncomingValues(); ++i)
-                {
-                    collectSym(phi->getIncomingValue(i));
-                }
-            }
-            else if (const GetElementPtrInst *gep = SVFUtil::dyn_cast<GetElementPtrInst>(
-                    inst))
-            {
-                collectSym(gep->getPointerOperand());
-            }
-            else if (const SelectInst *sel = SVFUtil::dyn_cast<SelectInst>(inst))
-            {
-                collectSym(sel->getTrueValue());
-                collectSym(sel->getFalseValue());
-            }
-            else if (const BinaryOperator *binary = SVFUtil::dyn_cast<BinaryOperator>(inst))
-            {
-                for (u32_t i = 0; i < binary->getNumOperands(); i++)
-                    collectSym(binary->getOperand(i));
-            }
-            else if (const UnaryOperator *unary = SVFUtil::dyn_cast<UnaryOperator>(inst))
-            {
-                for (u32_t i = 0; i < unary->getNumOperands(); i++)
-                    collectSym(unary->getOperand(i));
-            }
-            else if (const CmpInst *cmp = SVFUtil::dyn_cast<CmpInst>(inst))
-            {
-                for (u32_t i = 0; i < cmp->getNumOperands(); i++)
-                    collectSym(cmp->getOperand(i));
-            }
-            else if (const CastInst *cast = SVFUtil::dyn_cast<CastInst>(inst))
-            {
-                collectSym(cast->getOperand(0));
-            }
-            else if (const ReturnInst *ret = SVFUtil::dyn_cast<ReturnInst>(inst))
-            {
-                if(ret->getReturnValue())
-                    collectSym(ret->getReturnValue());
-            }
-            else if (const BranchInst *br = SVFUtil::dyn_cast<BranchInst>(inst))
+    symInfo->totalSymNum = NodeIDAllocator::get()->endSymbolAllocation();
+    if (Options::SymTabPrint) {
+        SymbolTableInfo::SymbolInfo()->dump();
+    }
+}
+
+/*!
+ * Collect the symbols of a function in the order they are met, without creating them,
+ * so that functions can be handled on multiple threads.
+ */
+void SymbolTableBuilder::collectFunSyms(const Function* fun, FunSyms& funSyms) const
+{
+    Set<const Value*> visited;
+    auto addSym = [&](const Value* val)
+    {
+        if (visited.insert(val).second && !SymbolTableInfo::isNullPtrSym(val) && !SymbolTableInfo::isBlackholeSym(val))
+            funSyms.syms.push_back(val);
+    };
+
+    // Add symbols for all formal parameters.
+    for (Function::const_arg_iterator I = fun->arg_begin(), E = fun->arg_end();
+            I != E; ++I)
+    {
+        addSym(&*I);
+    }
+
+    // collect and create symbols inside the function body
+    for (const_inst_iterator II = inst_begin(*fun), E = inst_end(*fun); II != E; ++II)
+    {
+        const Instruction *inst = &*II;
+        addSym(inst);
+
+        // initialization for some special instructions
+        //{@
+        if (const StoreInst *st = SVFUtil::dyn_cast<StoreInst>(inst))
+        {
+            addSym(st->getPointerOperand());
+            addSym(st->getValueOperand());
+        }
+        else if (const LoadInst *ld = SVFUtil::dyn_cast<LoadInst>(inst))
+        {
+            addSym(ld->getPointerOperand());
+        }
+        else if (const PHINode *phi = SVFUtil::dyn_cast<PHINode>(inst))
+        {
+            for (u32_t i = 0; i < phi->getNumIncomingValues(); ++i)
             {
-                Value* opnd = br->isConditional() ? br->getCondition() : br->getOperand(0);
-                collectSym(opnd);
+                addSym(phi->getIncomingValue(i));
             }
-            else if (const SwitchInst *sw = SVFUtil::dyn_cast<SwitchInst>(inst))
+        }
+        else if (const GetElementPtrInst *gep = SVFUtil::dyn_cast<GetElementPtrInst>(
+                inst))
+        {
+            addSym(gep->getPointerOperand());
+        }
+        else if (const SelectInst *sel = SVFUtil::dyn_cast<SelectInst>(inst))
+        {
+            addSym(sel->getTrueValue());
+            addSym(sel->getFalseValue());
+        }
+        else if (const BinaryOperator *binary = SVFUtil::dyn_cast<BinaryOperator>(inst))
+        {
+            for (u32_t i = 0; i < binary->getNumOperands(); i++)
+                addSym(binary->getOperand(i));
+        }
+        else if (const UnaryOperator *unary = SVFUtil::dyn_cast<UnaryOperator>(inst))
+        {
+            for (u32_t i = 0; i < unary->getNumOperands(); i++)
+                addSym(unary->getOperand(i));
+        }
+        else if (const CmpInst *cmp = SVFUtil::dyn_cast<CmpInst>(inst))
+        {
+            for (u32_t i = 0; i < cmp->getNumOperands(); i++)
+                addSym(cmp->getOperand(i));
+        }
+        else if (const CastInst *cast = SVFUtil::dyn_cast<CastInst>(inst))
+        {
+            addSym(cast->getOperand(0));
+        }
+        else if (const ReturnInst *ret = SVFUtil::dyn_cast<ReturnInst>(inst))
+        {
+            if(ret->getReturnValue())
+                addSym(ret->getReturnValue());
+        }
+        else if (const BranchInst *br = SVFUtil::dyn_cast<BranchInst>(inst))
+        {
+            Value* opnd = br->isConditional() ? br->getCondition() : br->getOperand(0);
+            addSym(opnd);
+        }
+        else if (const SwitchInst *sw = SVFUtil::dyn_cast<SwitchInst>(inst))
+        {
+            addSym(sw->getCondition());
+        }
+        else if (isNonInstricCallSite(inst))
+        {
+
+            CallSite cs = SVFUtil::getLLVMCallSite(inst);
+            funSyms.callSites.push_back(cs);
+            for (CallSite::arg_iterator it = cs.arg_begin();
+                    it != cs.arg_end(); ++it)
             {
-                collectSym(sw->getCondition());
+                addSym(*it);
             }
-            else if (isNonInstricCallSite(inst))
-            {
+            // Calls to inline asm need to be added as well because the callee isn't
+            // referenced anywhere else.
+            const Value *Callee = cs.getCalledValue();
+            addSym(Callee);
 
-                CallSite cs = SVFUtil::getLLVMCallSite(inst);
-                symInfo->callSiteSet.insert(cs);
-                for (CallSite::arg_iterator it = cs.arg_begin();
-                        it != cs.arg_end(); ++it)
-                {
-                    collectSym(*it);
-                }
-                // Calls to inline asm need to be added as well because the callee isn't
-                // referenced anywhere else.
-                const Value *Callee = cs.getCalledValue();
-                collectSym(Callee);
-
-                //TODO handle inlineAsm
-                ///if (SVFUtil::isa<InlineAsm>(Callee))
+            //TODO handle inlineAsm
+            ///if (SVFUtil::isa<InlineAsm>(Callee))
 
-            }
-            //@}
         }
+        //@}
     }
+}
 
-    symInfo->totalSymNum = NodeIDAllocator::get()->endSymbolAllocation();
-    if (Options::SymTabPrint) {
-        SymbolTableInfo::SymbolInfo()->dump();
+/*!
+ * Create the symbols of a function and its collected symbols
+ */
+void SymbolTableBuilder::createFunSyms(Function* fun, const FunSyms& funSyms)
+{
+    collectSym(fun);
+    collectRet(fun);
+    if (fun->getFunctionType()->isVarArg())
+        collectVararg(fun);
+
+    for (const Value* val : funSyms.syms)
+        collectSym(val);
+    for (const CallSite& cs : funSyms.callSites)
+        symInfo->callSiteSet.insert(cs);
+}
+
+/*!
+ * Collect the field info (StInfo) of all sized struct types of the modules on multiple threads
+ */
+void SymbolTableBuilder::collectStructTypeInfo(u32_t numThreads)
+{
+    std::vector<const Type*> types;
+    Set<const Type*> visited;
+    LLVMModuleSet* modSet = LLVMModuleSet::getLLVMModuleSet();
+    for (u32_t i = 0; i < modSet->getModuleNum(); ++i)
+    {
+        llvm::TypeFinder structTypes;
+        structTypes.run(modSet->getModuleRef(i), false);
+        for (StructType* sty : structTypes)
+        {
+            // isSized caches its result in the type, query it before the types are shared by threads
+            if (sty->isSized() && visited.insert(sty).second)
+                types.push_back(sty);
+        }
     }
+    symInfo->collectTypeInfo(types, numThreads);
 }
 
 /*!
@@ -35,15 +35,57 @@
 using namespace SVF;
 
 
-CondExpr* CondManager::trueCond = nullptr;
-CondExpr* CondManager::falseCond = nullptr;
 CondManager* CondManager::condMgr = nullptr;
-u32_t CondManager::totalCondNum = 0;
+std::atomic<u32_t> CondManager::totalCondNum(0);
+
+/// Condition manager bound to the current thread, owned by the caller of setThreadCondMgr
+static thread_local CondManager* threadCondMgr = nullptr;
+
+/*!
+ * Get the condition manager, i.e., the one bound to the current thread if any, or the global one
+ */
+CondManager* CondManager::getCondMgr()
+{
+    if (threadCondMgr != nullptr)
+        return threadCondMgr;
+    if (condMgr == nullptr)
+    {
+        condMgr = new CondManager();
+    }
+    return condMgr;
+}
+
+/*!
+ * Release the global condition manager
+ */
+void CondManager::releaseCondMgr()
+{
+    delete condMgr;
+    condMgr = nullptr;
+}
+
+/*!
+ * Create a condition manager for a worker thread, owned by the caller
+ */
+CondManager* CondManager::createThreadCondMgr()
+{
+    return new CondManager();
+}
+
+/*!
+ * Bind mgr to the current thread (or unbind the current one if mgr is nullptr).
+ * The thread does not own mgr, which hence outlives the thread if the caller wishes.
+ */
+void CondManager::setThreadCondMgr(CondManager* mgr)
+{
+    threadCondMgr = mgr;
+}
 
 /*!
  * Constructor
  */
-CondManager::CondManager() : sol(cxt)
+CondManager::CondManager() : sol(cxt), trueCond(nullptr), falseCond(nullptr),
+    satCacheHits(0), satCacheMisses(0), solverTime(0)
 {
     const z3::expr &trueExpr = cxt.bool_val(true);
     trueCond = getOrAddBranchCond(trueExpr, branchCondManager.getTrueCond());
@@ -90,7 +132,14 @@ z3::expr CondManager::simplify(const z3::expr& expr) const{
  */
 CondExpr* CondManager::createFreshBranchCond(const Instruction* inst)
 {
-    u32_t condCountIdx = totalCondNum++;
+    return getOrAddFreshBranchCond(totalCondNum++, inst);
+}
+
+/*!
+ * Get or add the branch condition of the condCountIdx-th condition variable
+ */
+CondExpr* CondManager::getOrAddFreshBranchCond(u32_t condCountIdx, const Instruction* inst)
+{
     const z3::expr &expr = cxt.bool_const(("c" + std::to_string(condCountIdx)).c_str());
     IDToCondExprMap::const_iterator it = allocatedConds.find(expr.id());
     if (it != allocatedConds.end())
@@ -122,6 +171,62 @@ CondExpr* CondManager::getOrAddBranchCond(const z3::expr& e, BranchCond* branchC
     }
 }
 
+/*!
+ * Translate a condition allocated by srcMgr into this manager.
+ * Condition variables are numbered by the shared counter totalCondNum,
+ * so a fresh condition is mapped to the variable with the same index here,
+ * and compound conditions are rebuilt using the operations of this manager.
+ */
+CondExpr* CondManager::translate(const CondExpr* cond, const CondManager* srcMgr)
+{
+    if (srcMgr == this)
+        return getCond(cond->getId());
+    Map<const CondExpr*, CondExpr*> translated;
+    return translate(cond, srcMgr, translated);
+}
+
+CondExpr* CondManager::translate(const CondExpr* cond, const CondManager* srcMgr, Map<const CondExpr*, CondExpr*>& translated)
+{
+    if (cond == srcMgr->getTrueCond())
+        return getTrueCond();
+    else if (cond == srcMgr->getFalseCond())
+        return getFalseCond();
+
+    auto it = translated.find(cond);
+    if (it != translated.end())
+        return it->second;
+
+    const z3::expr& e = cond->getExpr();
+    CondExpr* res = nullptr;
+    switch (e.decl().decl_kind())
+    {
+    case Z3_OP_AND:
+    case Z3_OP_OR:
+    {
+        res = translate(srcMgr->getCond(e.arg(0).id()), srcMgr, translated);
+        for (u32_t i = 1; i < e.num_args(); ++i)
+        {
+            CondExpr* sub = translate(srcMgr->getCond(e.arg(i).id()), srcMgr, translated);
+            res = e.decl().decl_kind() == Z3_OP_AND ? AND(res, sub) : OR(res, sub);
+        }
+        break;
+    }
+    case Z3_OP_NOT:
+    {
+        res = NEG(translate(srcMgr->getCond(e.arg(0).id()), srcMgr, translated));
+        break;
+    }
+    default:
+    {
+        BranchCond* branchCond = SVFUtil::dyn_cast<BranchCondExpr>(cond)->getBranchCond();
+        res = getOrAddFreshBranchCond(Cudd_Regular(branchCond)->index, srcMgr->getCondInst(cond));
+        break;
+    }
+    }
+    translated[cond] = res;
+    return res;
+}
+
 /*!
  * Return the number of condition expressions
  */
@@ -217,16 +322,67 @@ void CondManager::extractSubConds(const CondExpr* cond, NodeBS &support) const
 }
 
 /*!
- * Whether the condition is satisfiable
+ * Collect the conjuncts of a condition in order
+ */
+void CondManager::collectConjuncts(const z3::expr& e, std::vector<z3::expr>& conjuncts) const
+{
+    if (e.decl().decl_kind() == Z3_OP_AND)
+    {
+        for (u32_t i = 0; i < e.num_args(); ++i)
+            collectConjuncts(e.arg(i), conjuncts);
+    }
+    else
+        conjuncts.push_back(e);
+}
+
+/*!
+ * Whether the condition is satisfiable.
+ * Results are memoised by condition id. With -incremental-sat, the conjuncts of a guard are
+ * asserted in their own solver scopes, so that a later guard sharing a prefix of conjuncts
+ * (e.g., a guard extended along a value-flow path) only pops and pushes the differing suffix.
  */
 bool CondManager::isSatisfiable(const CondExpr* cond){
-    sol.reset();
-    sol.add(cond->getExpr());
-    z3::check_result result = sol.check();
-    if (result == z3::sat || result == z3::unknown)
-        return true;
+    Map<u32_t, bool>::const_iterator it = satCache.find(cond->getId());
+    if (it != satCache.end())
+    {
+        satCacheHits++;
+        return it->second;
+    }
+    satCacheMisses++;
+
+    double start = PTAStat::getClk(true);
+    if (Options::IncrementalSat)
+    {
+        std::vector<z3::expr> conjuncts;
+        collectConjuncts(cond->getExpr(), conjuncts);
+        u32_t shared = 0;
+        while (shared < assertedConjuncts.size() && shared < conjuncts.size()
+                && assertedConjuncts[shared] == conjuncts[shared].id())
+            shared++;
+        if (shared < assertedConjuncts.size())
+        {
+            sol.pop(assertedConjuncts.size() - shared);
+            assertedConjuncts.resize(shared);
+        }
+        for (u32_t i = shared; i < conjuncts.size(); ++i)
+        {
+            sol.push();
+            sol.add(conjuncts[i]);
+            assertedConjuncts.push_back(conjuncts[i].id());
+        }
+    }
     else
-        return false;
+    {
+        sol.reset();
+        assertedConjuncts.clear();
+        sol.add(cond->getExpr());
+    }
+    z3::check_result result = sol.check();
+    solverTime += (PTAStat::getClk(true) - start) / TIMEINTERVAL;
+
+    bool sat = (result == z3::sat || result == z3::unknown);
+    satCache[cond->getId()] = sat;
+    return sat;
 }
 
 /*!
@@ -254,6 +410,56 @@ std::string CondManager::dumpStr(const CondExpr *e) const
     return out.str();
 }
 
+/*!
+ * Constructor
+ */
+BranchCondManager::BranchCondManager()
+{
+    m_bdd_mgr = Cudd_Init(0, 0, CUDD_UNIQUE_SLOTS, CUDD_CACHE_SLOTS, (unsigned long)Options::BddMaxMem << 20);
+    initReorderAndGC();
+}
+
+/*!
+ * Set up dynamic variable reordering (e.g., sifting, window permutation), garbage collection and table growth
+ */
+void BranchCondManager::initReorderAndGC()
+{
+    const std::string& method = Options::BddReorder;
+    Cudd_ReorderingType heuristic = CUDD_REORDER_NONE;
+    if (method == "sift")
+        heuristic = CUDD_REORDER_SIFT;
+    else if (method == "sift-conv")
+        heuristic = CUDD_REORDER_SIFT_CONVERGE;
+    else if (method == "symm-sift")
+        heuristic = CUDD_REORDER_SYMM_SIFT;
+    else if (method == "window2")
+        heuristic = CUDD_REORDER_WINDOW2;
+    else if (method == "window3")
+        heuristic = CUDD_REORDER_WINDOW3;
+    else if (method == "window4")
+        heuristic = CUDD_REORDER_WINDOW4;
+    else if (method != "none")
+        SVFUtil::writeWrnMsg("unknown bdd reordering method " + method + ", reordering is disabled\n");
+
+    if (heuristic != CUDD_REORDER_NONE)
+    {
+        m_bdd_mgr->autoDyn = 1;
+        m_bdd_mgr->autoMethod = heuristic;
+        if (Options::BddReorderThreshold)
+            m_bdd_mgr->nextDyn = Options::BddReorderThreshold;
+    }
+    m_bdd_mgr->gcEnabled = Options::BddGC ? 1 : 0;
+    if (Options::BddGCFrac)
+    {
+        m_bdd_mgr->gcFrac = std::min(100u, (unsigned)Options::BddGCFrac) / 100.0;
+        m_bdd_mgr->minDead = (unsigned)(m_bdd_mgr->gcFrac * m_bdd_mgr->slots);
+    }
+    if (Options::BddMinHit)
+        Cudd_SetMinHit(m_bdd_mgr, std::min(99u, (unsigned)Options::BddMinHit));
+    if (Options::BddLooseUpTo)
+        m_bdd_mgr->looseUpTo = Options::BddLooseUpTo;
+}
+
 /// Operations on conditions.
 //@{
 /// use Cudd_bddAndLimit interface to avoid bdds blow up
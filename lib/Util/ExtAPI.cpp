@@ -8,7 +8,13 @@
 */
 
 #include "Util/ExtAPI.h"
+#include "Util/Options.h"
+#include "Util/SVFUtil.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/xxhash.h"
 #include <stdio.h>
+#include <string.h>
 
 using namespace std;
 using namespace SVF;
@@ -25,9 +31,56 @@ struct ei_pair
 
 } // End anonymous namespace
 
-//Each (name, type) pair will be inserted into the map.
+//The name of each extf_t as written in -ext-api-spec files.
+static const ei_pair ef_names[]=
+{
+    {"EFT_NOOP", ExtAPI::EFT_NOOP},
+    {"EFT_ALLOC", ExtAPI::EFT_ALLOC},
+    {"EFT_REALLOC", ExtAPI::EFT_REALLOC},
+    {"EFT_FREE", ExtAPI::EFT_FREE},
+    {"EFT_NOSTRUCT_ALLOC", ExtAPI::EFT_NOSTRUCT_ALLOC},
+    {"EFT_STAT", ExtAPI::EFT_STAT},
+    {"EFT_STAT2", ExtAPI::EFT_STAT2},
+    {"EFT_L_A0", ExtAPI::EFT_L_A0},
+    {"EFT_L_A1", ExtAPI::EFT_L_A1},
+    {"EFT_L_A2", ExtAPI::EFT_L_A2},
+    {"EFT_L_A8", ExtAPI::EFT_L_A8},
+    {"EFT_L_A0__A0R_A1", ExtAPI::EFT_L_A0__A0R_A1},
+    {"EFT_L_A0__A0R_A1R", ExtAPI::EFT_L_A0__A0R_A1R},
+    {"EFT_L_A1__FunPtr", ExtAPI::EFT_L_A1__FunPtr},
+    {"EFT_A1R_A0R", ExtAPI::EFT_A1R_A0R},
+    {"EFT_A3R_A1R_NS", ExtAPI::EFT_A3R_A1R_NS},
+    {"EFT_A1R_A0", ExtAPI::EFT_A1R_A0},
+    {"EFT_A2R_A1", ExtAPI::EFT_A2R_A1},
+    {"EFT_A4R_A1", ExtAPI::EFT_A4R_A1},
+    {"EFT_L_A0__A2R_A0", ExtAPI::EFT_L_A0__A2R_A0},
+    {"EFT_L_A0__A1_A0", ExtAPI::EFT_L_A0__A1_A0},
+    {"EFT_A0R_NEW", ExtAPI::EFT_A0R_NEW},
+    {"EFT_A1R_NEW", ExtAPI::EFT_A1R_NEW},
+    {"EFT_A2R_NEW", ExtAPI::EFT_A2R_NEW},
+    {"EFT_A4R_NEW", ExtAPI::EFT_A4R_NEW},
+    {"EFT_A11R_NEW", ExtAPI::EFT_A11R_NEW},
+    {"EFT_STD_RB_TREE_INSERT_AND_REBALANCE", ExtAPI::EFT_STD_RB_TREE_INSERT_AND_REBALANCE},
+    {"EFT_STD_RB_TREE_INCREMENT", ExtAPI::EFT_STD_RB_TREE_INCREMENT},
+    {"EFT_STD_LIST_HOOK", ExtAPI::EFT_STD_LIST_HOOK},
+    {"CPP_EFT_A0R_A1", ExtAPI::CPP_EFT_A0R_A1},
+    {"CPP_EFT_A0R_A1R", ExtAPI::CPP_EFT_A0R_A1R},
+    {"CPP_EFT_A1R", ExtAPI::CPP_EFT_A1R},
+    {"EFT_CXA_BEGIN_CATCH", ExtAPI::EFT_CXA_BEGIN_CATCH},
+    {"CPP_EFT_DYNAMIC_CAST", ExtAPI::CPP_EFT_DYNAMIC_CAST},
+    {"EFT_OTHER", ExtAPI::EFT_OTHER},
+    {0, ExtAPI::EFT_NOOP}
+};
+
+//Header of the binary cache of a spec file:
+//  magic, version, size and modification time (ns) of the spec file, xxHash64 of its text, number of entries;
+//  then for each entry: its extf_t (u32), the length of its name (u32), and the name.
+static const u32_t SpecCacheMagic= 0x53455653;   // "SVES"
+static const u32_t SpecCacheVersion= 3;
+
+//Each (name, type) pair will be inserted into extNameTable.
 //All entries of the same type must occur together (for error detection).
-static const ei_pair ei_pairs[]=
+static constexpr ei_pair ei_pairs[]=
 {
     //The current llvm-gcc puts in the \01.
     {"\01creat64", ExtAPI::EFT_NOOP},
@@ -821,6 +874,70 @@ static const ei_pair ei_pairs[]=
     {0, ExtAPI::EFT_NOOP}
 };
 
+namespace {
+
+//FNV-1a hash of a function name, usable when building extNameTable at compile time.
+constexpr u32_t hashExtName(const char *n, size_t len)
+{
+    u32_t h= 2166136261u;
+    for(size_t i= 0; i < len; ++i)
+    {
+        h^= static_cast<unsigned char>(n[i]);
+        h*= 16777619u;
+    }
+    return h;
+}
+
+constexpr size_t extNameLen(const char *n)
+{
+    size_t len= 0;
+    while(n[len])
+        ++len;
+    return len;
+}
+
+//Size of extNameTable, a power of two at least twice the number of entries in ei_pairs.
+constexpr u32_t ExtNameTableSize= 2048;
+
+//Open addressing (linear probing) table of the names in ei_pairs, built at compile time.
+//Each slot holds 1 + the index of an entry of ei_pairs, 0 if the slot is empty.
+struct ExtNameTable
+{
+    u32_t slots[ExtNameTableSize];
+};
+
+constexpr ExtNameTable buildExtNameTable()
+{
+    ExtNameTable table= {};
+    for(u32_t i= 0; ei_pairs[i].n; ++i)
+    {
+        u32_t slot= hashExtName(ei_pairs[i].n, extNameLen(ei_pairs[i].n)) & (ExtNameTableSize - 1);
+        while(table.slots[slot])
+            slot= (slot + 1) & (ExtNameTableSize - 1);
+        table.slots[slot]= i + 1;
+    }
+    return table;
+}
+
+constexpr ExtNameTable extNameTable= buildExtNameTable();
+
+static_assert(sizeof(ei_pairs) / sizeof(ei_pair) * 2 <= ExtNameTableSize, "extNameTable is too small for ei_pairs");
+
+//Index of the entry of ei_pairs for (name), -1 if it is not there.
+int findExtName(llvm::StringRef name)
+{
+    u32_t slot= hashExtName(name.data(), name.size()) & (ExtNameTableSize - 1);
+    while(u32_t entry= extNameTable.slots[slot])
+    {
+        if(name == ei_pairs[entry - 1].n)
+            return entry - 1;
+        slot= (slot + 1) & (ExtNameTableSize - 1);
+    }
+    return -1;
+}
+
+} // End anonymous namespace
+
 /*  FIXME:
  *  SSL_CTX_ctrl, SSL_ctrl - may set the ptr field arg0->x
  *  SSL_CTX_set_verify - sets the function ptr field arg0->x
@@ -866,13 +983,169 @@ void ExtAPI::init()
             t_seen.insert(p->t);
             prev_t= p->t;
         }
-        if(info.count(p->n))
+        //A duplicate name is found at the index of its first occurrence.
+        if(findExtName(p->n) != p - ei_pairs)
         {
             fputs(p->n, stderr);
             putc('\n', stderr);
             assert(!"duplicate name in ei_pairs");
         }
-        info[p->n]= p->t;
+    }
+
+    if(!Options::ExtAPISpec.empty())
+        load_spec(Options::ExtAPISpec, Options::ExtAPISpecCache);
+}
+
+ExtAPI::extf_t ExtAPI::find_type(const SVFFunction* F) const
+{
+    if(!F->isDeclaration())
+        return EFT_OTHER;
+
+    std::string intrinsicName;
+    llvm::StringRef funName= F->getName();
+    if(F->isIntrinsic())
+    {
+        intrinsicName= "llvm." + F->getName().split('.').second.split('.').first.str();
+        funName= intrinsicName;
+    }
+
+    //Summaries given in -ext-api-spec take precedence over the built-in ones.
+    llvm::StringMap<extf_t>::const_iterator it= spec_types.find(funName);
+    if(it != spec_types.end())
+        return it->second;
+
+    int idx= findExtName(funName);
+    return idx < 0 ? EFT_OTHER : ei_pairs[idx].t;
+}
+
+/*!
+ * Load the summaries of a spec file. Compiling a spec file (which may list thousands of functions)
+ * can be done once if a cache file is given: the result is kept there along with the size and the
+ * hash of the text of the spec file. The spec is always read and hashed, which is cheap next to
+ * parsing it, so that the cache is reused only while the text is unchanged, whatever its
+ * modification time.
+ */
+void ExtAPI::load_spec(const std::string& specFile, const std::string& cacheFile)
+{
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> spec= llvm::MemoryBuffer::getFile(specFile);
+    if(!spec)
+    {
+        SVFUtil::errs() << "cannot read external function summaries " << specFile << ": " << spec.getError().message() << "\n";
+        return;
+    }
+
+    llvm::StringRef text= (*spec)->getBuffer();
+    if(cacheFile.empty())
+    {
+        parse_spec(text, specFile);
+        return;
+    }
+    SpecStamp stamp;
+    stamp.size= text.size();
+    stamp.hash= llvm::xxHash64(text);
+    if(read_spec_cache(cacheFile, stamp))
+        return;
+    parse_spec(text, specFile);
+    write_spec_cache(cacheFile, stamp);
+}
+
+/*!
+ * Each line of a spec file is "<function name> <extf_t name>", e.g. "my_malloc EFT_ALLOC".
+ * Anything after a '#' is a comment. A function listed twice keeps its last summary.
+ */
+void ExtAPI::parse_spec(llvm::StringRef text, const std::string& specFile)
+{
+    llvm::StringMap<extf_t> names;
+    for(const ei_pair *p= ef_names; p->n; ++p)
+        names[p->n]= p->t;
+
+    u32_t lineNo= 0;
+    while(!text.empty())
+    {
+        llvm::StringRef line;
+        std::tie(line, text)= text.split('\n');
+        ++lineNo;
+        line= line.split('#').first.trim();
+        if(line.empty())
+            continue;
+
+        size_t sep= line.find_first_of(" \t");
+        llvm::StringRef funName= line.substr(0, sep);
+        llvm::StringRef kind= line.substr(sep).trim();
+        llvm::StringMap<extf_t>::const_iterator it= names.find(kind);
+        if(funName.empty() || it == names.end())
+        {
+            SVFUtil::writeWrnMsg(specFile + ":" + std::to_string(lineNo) + ": expected \"<function> <EFT_kind>\", ignored");
+            continue;
+        }
+        spec_types[funName]= it->second;
     }
 }
 
+bool ExtAPI::read_spec_cache(const std::string& cacheFile, const SpecStamp& stamp)
+{
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> cache= llvm::MemoryBuffer::getFile(cacheFile);
+    if(!cache)
+        return false;
+
+    const char* pos= (*cache)->getBufferStart();
+    const char* end= (*cache)->getBufferEnd();
+    auto read= [&](void* dst, size_t size) -> bool
+    {
+        if(static_cast<size_t>(end - pos) < size)
+            return false;
+        memcpy(dst, pos, size);
+        pos+= size;
+        return true;
+    };
+
+    u32_t magic, version, num;
+    SpecStamp cached;
+    if(!read(&magic, sizeof(magic)) || magic != SpecCacheMagic
+            || !read(&version, sizeof(version)) || version != SpecCacheVersion
+            || !read(&cached.size, sizeof(cached.size)) || !read(&cached.hash, sizeof(cached.hash))
+            || !read(&num, sizeof(num)))
+        return false;
+    if(cached.size != stamp.size || cached.hash != stamp.hash)
+        return false;
+
+    llvm::StringMap<extf_t> types(num);
+    for(u32_t i= 0; i < num; ++i)
+    {
+        u32_t t, len;
+        if(!read(&t, sizeof(t)) || t > EFT_OTHER || !read(&len, sizeof(len))
+                || static_cast<size_t>(end - pos) < len)
+            return false;
+        types[llvm::StringRef(pos, len)]= static_cast<extf_t>(t);
+        pos+= len;
+    }
+
+    spec_types= std::move(types);
+    return true;
+}
+
+void ExtAPI::write_spec_cache(const std::string& cacheFile, const SpecStamp& stamp) const
+{
+    std::error_code EC;
+    llvm::raw_fd_ostream os(cacheFile, EC, llvm::sys::fs::OF_None);
+    if(EC)
+    {
+        SVFUtil::writeWrnMsg("cannot write external function summary cache " + cacheFile + ": " + EC.message());
+        return;
+    }
+
+    u32_t num= spec_types.size();
+    os.write(reinterpret_cast<const char*>(&SpecCacheMagic), sizeof(SpecCacheMagic));
+    os.write(reinterpret_cast<const char*>(&SpecCacheVersion), sizeof(SpecCacheVersion));
+    os.write(reinterpret_cast<const char*>(&stamp.size), sizeof(stamp.size));
+    os.write(reinterpret_cast<const char*>(&stamp.hash), sizeof(stamp.hash));
+    os.write(reinterpret_cast<const char*>(&num), sizeof(num));
+    for(const llvm::StringMapEntry<extf_t>& entry : spec_types)
+    {
+        u32_t t= entry.second;
+        u32_t len= entry.first().size();
+        os.write(reinterpret_cast<const char*>(&t), sizeof(t));
+        os.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        os.write(entry.first().data(), len);
+    }
+}
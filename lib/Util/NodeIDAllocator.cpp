@@ -1,8 +1,13 @@
 //===- NodeIDAllocator.cpp -- Allocates node IDs on request ------------------------//
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <queue>
+#include <set>
+#include <thread>
+#include <tuple>
 
 #include "FastCluster/fastcluster.h"
 #include "MemoryModel/PointerAnalysisImpl.h"
@@ -172,10 +177,26 @@ namespace SVF
     const std::string NodeIDAllocator::Clusterer::LargestRegion = "LargestRegion";
     const std::string NodeIDAllocator::Clusterer::BestCandidate = "BestCandidate";
     const std::string NodeIDAllocator::Clusterer::NumNonTrivialRegionObjects = "NumNonTrivObj";
+    const std::string NodeIDAllocator::Clusterer::NumSparseRegions = "NumSparseRegions";
+    const std::string NodeIDAllocator::Clusterer::RemapOldWords = "RemapOldWords";
+    const std::string NodeIDAllocator::Clusterer::RemapSavedBits = "RemapSavedBits";
 
     std::vector<NodeID> NodeIDAllocator::Clusterer::cluster(BVDataPTAImpl *pta, const std::vector<std::pair<NodeID, unsigned>> keys, std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> &candidates, std::string evalSubtitle)
     {
         assert(pta != nullptr && "Clusterer::cluster: given null BVDataPTAImpl");
+
+        // Map points-to sets to occurrences.
+        Map<PointsTo, unsigned> pointsToSets;
+        for (const std::pair<NodeID, unsigned> &keyOcc : keys)
+        {
+            pointsToSets[pta->getPts(keyOcc.first)] += keyOcc.second;
+        }
+
+        return cluster(pointsToSets, candidates, evalSubtitle);
+    }
+
+    std::vector<NodeID> NodeIDAllocator::Clusterer::cluster(const Map<PointsTo, unsigned> &pointsToSets, std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> &candidates, std::string evalSubtitle, StatsList *deferredStats, const std::atomic<bool> *cancelled)
+    {
         assert(Options::NodeAllocStrat == Strategy::DENSE && "Clusterer::cluster: only dense allocation clustering currently supported");
 
         Map<std::string, std::string> overallStats;
@@ -191,30 +212,21 @@ namespace SVF
 
         double clkStart = PTAStat::getClk(true);
 
-        // Map points-to sets to occurrences.
-        Map<PointsTo, unsigned> pointsToSets;
-
         // Objects each object shares at least a points-to set with.
         Map<NodeID, Set<NodeID>> coPointeeGraph;
-        for (const std::pair<NodeID, unsigned> &keyOcc : keys)
+        for (const Map<PointsTo, unsigned>::value_type &ptsOcc : pointsToSets)
         {
-            const PointsTo &pts = pta->getPts(keyOcc.first);
-            const size_t oldSize = pointsToSets.size();
-            pointsToSets[pts] += keyOcc.second;;
-
             // Edges in this graph have no weight or uniqueness, so we only need to
             // do this for each points-to set once.
-            if (oldSize != pointsToSets.size())
+            const PointsTo &pts = ptsOcc.first;
+            NodeID firstO = !pts.empty() ? *(pts.begin()) : 0;
+            Set<NodeID> &firstOsNeighbours = coPointeeGraph[firstO];
+            for (const NodeID o : pts)
             {
-                NodeID firstO = !pts.empty() ? *(pts.begin()) : 0;
-                Set<NodeID> &firstOsNeighbours = coPointeeGraph[firstO];
-                for (const NodeID o : pts)
+                if (o != firstO)
                 {
-                    if (o != firstO)
-                    {
-                        firstOsNeighbours.insert(o);
-                        coPointeeGraph[o].insert(firstO);
-                    }
+                    firstOsNeighbours.insert(o);
+                    coPointeeGraph[o].insert(firstO);
                 }
             }
         }
@@ -307,13 +319,118 @@ namespace SVF
             methods.push_back(Options::ClusterMethod);
         }
 
-        for (const hclust_fast_methods method : methods)
+        // Regions of at least NATIVE_INT_SIZE objects are clustered. How the objects of such a region
+        // are ordered does not depend on other regions, so regions are shared out amongst threads and
+        // every method's ordering is computed from one distance matrix (copied since fastcluster
+        // overwrites it). The orderings are turned into a node mapping afterwards.
+        std::vector<unsigned> nonTrivialRegions;
+        unsigned largestRegion = 0;
+        unsigned nonTrivialRegionObjects = 0;
+        for (unsigned region = 0; region < numRegions; ++region)
+        {
+            const size_t regionNumObjects = regionsObjects[region].size();
+            if (regionNumObjects > largestRegion) largestRegion = regionNumObjects;
+            if (regionNumObjects < NATIVE_INT_SIZE) continue;
+            nonTrivialRegions.push_back(region);
+            nonTrivialRegionObjects += regionNumObjects;
+        }
+
+        // Largest regions first so they do not end up being clustered last by a single thread.
+        std::stable_sort(nonTrivialRegions.begin(), nonTrivialRegions.end(),
+                         [&regionsObjects](unsigned r1, unsigned r2) { return regionsObjects[r1].size() > regionsObjects[r2].size(); });
+
+        // regionOrders[m][region][i] is the position of the ith object of region (as per
+        // regionMappings) when clustering with methods[m].
+        std::vector<std::vector<std::vector<NodeID>>> regionOrders(methods.size(), std::vector<std::vector<NodeID>>(numRegions));
+        const unsigned numThreads = std::max(1u, std::min<unsigned>(Options::ClusterThreads, nonTrivialRegions.size()));
+        // A lone region can at least fill its distance matrix with all threads.
+        const unsigned fillThreads = nonTrivialRegions.size() == 1 ? std::max(1u, (unsigned)Options::ClusterThreads) : 1;
+        std::vector<double> workerDistanceMatrixTime(numThreads, 0.0);
+        std::vector<double> workerFastClusterTime(numThreads, 0.0);
+        std::vector<double> workerDendrogramTraversalTime(numThreads, 0.0);
+        std::atomic<unsigned> numSparseRegions(0);
+        std::atomic<unsigned> nextRegion(0);
+        auto clusterRegions = [&](unsigned worker)
+        {
+            for (unsigned r = nextRegion++; r < nonTrivialRegions.size(); r = nextRegion++)
+            {
+                if (cancelled != nullptr && cancelled->load()) break;
+
+                const unsigned region = nonTrivialRegions[r];
+                const size_t regionNumObjects = regionsObjects[region].size();
+
+                if (Options::ClusterMaxMatrixObjects != 0 && regionNumObjects > Options::ClusterMaxMatrixObjects)
+                {
+                    // The matrix would be too large, so every method falls back to sparse single linkage.
+                    ++numSparseRegions;
+                    const double clkStart = PTAStat::getClk(true);
+                    const std::vector<NodeID> order = getSparseSingleLinkageOrder(regionsPointsTos[region], regionNumObjects,
+                                                                                  regionReverseMappings[region]);
+                    for (std::vector<std::vector<NodeID>> &methodOrders : regionOrders) methodOrders[region] = order;
+                    const double clkEnd = PTAStat::getClk(true);
+                    workerFastClusterTime[worker] += (clkEnd - clkStart) / TIMEINTERVAL;
+                    continue;
+                }
+
+                double *distMatrix = getDistanceMatrix(regionsPointsTos[region], regionNumObjects,
+                                                       regionReverseMappings[region], workerDistanceMatrixTime[worker], fillThreads);
+                const size_t condensedSize = (regionNumObjects * (regionNumObjects - 1)) / 2;
+
+                // Dendrogram leaves are numbered 0 to n, which is what we want the positions of.
+                std::vector<NodeID> identity(regionNumObjects);
+                for (size_t i = 0; i < regionNumObjects; ++i) identity[i] = i;
+
+                for (size_t m = 0; m < methods.size(); ++m)
+                {
+                    double clkStart = PTAStat::getClk(true);
+                    // The last method can consume the original.
+                    double *methodDistMatrix = distMatrix;
+                    if (m + 1 != methods.size())
+                    {
+                        methodDistMatrix = new double[condensedSize];
+                        std::copy(distMatrix, distMatrix + condensedSize, methodDistMatrix);
+                    }
+
+                    int *dendrogram = new int[2 * (regionNumObjects - 1)];
+                    double *height = new double[regionNumObjects - 1];
+                    hclust_fast(regionNumObjects, methodDistMatrix, methods[m], dendrogram, height);
+                    delete[] methodDistMatrix;
+                    delete[] height;
+                    double clkEnd = PTAStat::getClk(true);
+                    workerFastClusterTime[worker] += (clkEnd - clkStart) / TIMEINTERVAL;
+
+                    clkStart = PTAStat::getClk(true);
+                    std::vector<NodeID> &order = regionOrders[m][region];
+                    order.resize(regionNumObjects, UINT_MAX);
+                    unsigned position = 0;
+                    Set<int> visited;
+                    traverseDendrogram(order, dendrogram, regionNumObjects, position,
+                                       visited, regionNumObjects - 1, identity);
+                    delete[] dendrogram;
+                    clkEnd = PTAStat::getClk(true);
+                    workerDendrogramTraversalTime[worker] += (clkEnd - clkStart) / TIMEINTERVAL;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < numThreads; ++t) workers.push_back(std::thread(clusterRegions, t));
+        clusterRegions(0);
+        for (std::thread &t : workers) t.join();
+
+        if (cancelled != nullptr && cancelled->load()) return std::vector<NodeID>();
+
+        for (unsigned t = 0; t < numThreads; ++t)
+        {
+            distanceMatrixTime += workerDistanceMatrixTime[t];
+            fastClusterTime += workerFastClusterTime[t];
+            dendrogramTraversalTime += workerDendrogramTraversalTime[t];
+        }
+
+        for (size_t m = 0; m < methods.size(); ++m)
         {
             std::vector<NodeID> nodeMap(numObjects, UINT_MAX);
 
-            unsigned numGtIntRegions = 0;
-            unsigned largestRegion = 0;
-            unsigned nonTrivialRegionObjects = 0;
             unsigned allocCounter = 0;
             for (unsigned region = 0; region < numRegions; ++region)
             {
@@ -326,8 +443,6 @@ namespace SVF
                         ((allocCounter + NATIVE_INT_SIZE - 1) / NATIVE_INT_SIZE) * NATIVE_INT_SIZE;
                 }
 
-                if (regionNumObjects > largestRegion) largestRegion = regionNumObjects;
-
                 // For regions with fewer than 64 objects, we can just allocate them
                 // however as they will be in the one int regardless..
                 if (regionNumObjects < NATIVE_INT_SIZE)
@@ -336,41 +451,22 @@ namespace SVF
                     continue;
                 }
 
-                ++numGtIntRegions;
-                nonTrivialRegionObjects += regionNumObjects;
-
-                double *distMatrix = getDistanceMatrix(regionsPointsTos[region], regionNumObjects,
-                                                       regionReverseMappings[region], distanceMatrixTime);
-
-                clkStart = PTAStat::getClk(true);
-                int *dendrogram = new int[2 * (regionNumObjects - 1)];
-                double *height = new double[regionNumObjects - 1];
-                hclust_fast(regionNumObjects, distMatrix, method, dendrogram, height);
-                delete[] distMatrix;
-                delete[] height;
-                clkEnd = PTAStat::getClk(true);
-                fastClusterTime += (clkEnd - clkStart) / TIMEINTERVAL;
-
-                clkStart = PTAStat::getClk(true);
-                Set<int> visited;
-                traverseDendrogram(nodeMap, dendrogram, regionNumObjects, allocCounter,
-                                   visited, regionNumObjects - 1, regionMappings[region]);
-                delete[] dendrogram;
-                clkEnd = PTAStat::getClk(true);
-                dendrogramTraversalTime += (clkEnd - clkStart) / TIMEINTERVAL;
+                const std::vector<NodeID> &order = regionOrders[m][region];
+                for (size_t i = 0; i < regionNumObjects; ++i) nodeMap[regionMappings[region][i]] = allocCounter + order[i];
+                allocCounter += regionNumObjects;
             }
 
-            candidates.push_back(std::make_pair(method, nodeMap));
-
-            // Though we "update" these in the loop, they will be the same every iteration.
-            overallStats[NumGtIntRegions] = std::to_string(numGtIntRegions);
-            overallStats[LargestRegion] = std::to_string(largestRegion);
-            overallStats[NumNonTrivialRegionObjects] = std::to_string(nonTrivialRegionObjects);
+            candidates.push_back(std::make_pair(methods[m], nodeMap));
         }
 
+        overallStats[NumGtIntRegions] = std::to_string(nonTrivialRegions.size());
+        overallStats[LargestRegion] = std::to_string(largestRegion);
+        overallStats[NumNonTrivialRegionObjects] = std::to_string(nonTrivialRegionObjects);
+        overallStats[NumSparseRegions] = std::to_string(numSparseRegions.load());
+
         // Work out which of the mappings we generated looks best.
         std::pair<hclust_fast_methods, std::vector<NodeID>> bestMapping = determineBestMapping(candidates, pointsToSets,
-                                                                                               evalSubtitle, evalTime);
+                                                                                               evalSubtitle, evalTime, deferredStats);
 
         overallStats[DistanceMatrixTime] = std::to_string(distanceMatrixTime);
         overallStats[DendrogramTraversalTime] = std::to_string(dendrogramTraversalTime);
@@ -379,7 +475,7 @@ namespace SVF
         overallStats[TotalTime] = std::to_string(distanceMatrixTime + dendrogramTraversalTime + fastClusterTime + regioningTime + evalTime);
 
         overallStats[BestCandidate] = SVFUtil::hclustMethodToString(bestMapping.first);
-        printStats(evalSubtitle + ": overall", overallStats);
+        printOrDeferStats(evalSubtitle + ": overall", overallStats, deferredStats);
 
         return bestMapping.second;
     }
@@ -417,75 +513,199 @@ namespace SVF
         return ((n - 1) / NATIVE_INT_SIZE + 1) * NATIVE_INT_SIZE;
     }
 
-    double *NodeIDAllocator::Clusterer::getDistanceMatrix(const std::vector<std::pair<const PointsTo *, unsigned>> pointsToSets,
+    inline void NodeIDAllocator::Clusterer::updateDistance(double &existingDistance, const unsigned distance, const unsigned occ)
+    {
+        // TODO: maybe use machine epsilon?
+        // For reducing distance due to extra occurrences.
+        // Can differentiate ~9999 occurrences.
+        const double occurrenceEpsilon = 0.0001;
+
+        // Subtract extra occurrenceEpsilon to make upcoming logic simpler.
+        // When existingDistance is never whole, it is always between two distances.
+        if (distance < existingDistance) existingDistance = distance - occurrenceEpsilon;
+
+        if (distance == std::ceil(existingDistance))
+        {
+            // We have something like distance == x, existingDistance == x - e, for some e < 1
+            // (potentially even set during this iteration).
+            // So, the new distance is an occurrence the existingDistance being tracked, it just
+            // had some reductions because of multiple occurences.
+            // If there is not room within this distance to reduce more (increase priority),
+            // just ignore it. TODO: maybe warn?
+            if (existingDistance - occ * occurrenceEpsilon > std::floor(existingDistance))
+            {
+                existingDistance -= occ * occurrenceEpsilon;
+            }
+            else
+            {
+                // Reached minimum.
+                existingDistance = std::floor(existingDistance) + occurrenceEpsilon;
+            }
+        }
+    }
+
+    double *NodeIDAllocator::Clusterer::getDistanceMatrix(const std::vector<std::pair<const PointsTo *, unsigned>> &pointsToSets,
                                                           const size_t numObjects, const Map<NodeID, unsigned> &nodeMap,
-                                                          double &distanceMatrixTime)
+                                                          double &distanceMatrixTime, unsigned numThreads)
     {
         const double clkStart = PTAStat::getClk(true);
         size_t condensedSize = (numObjects * (numObjects - 1)) / 2;
         double *distMatrix = new double[condensedSize];
         for (size_t i = 0; i < condensedSize; ++i) distMatrix[i] = numObjects * numObjects;
 
-        // TODO: maybe use machine epsilon?
-        // For reducing distance due to extra occurrences.
-        // Can differentiate ~9999 occurrences.
-        double occurrenceEpsilon = 0.0001;
+        // Thread t fills the rows congruent to t: every entry is only touched by one thread and
+        // sees the points-to sets in the same order as it would sequentially.
+        auto fillRows = [&](unsigned t)
+        {
+            for (const std::pair<const PointsTo *, unsigned> &ptsOcc : pointsToSets)
+            {
+                const PointsTo *pts = ptsOcc.first;
+                assert(pts != nullptr);
+                const unsigned occ = ptsOcc.second;
+
+                // Distance between each element of pts.
+                unsigned distance = requiredBits(*pts) / NATIVE_INT_SIZE;
+
+                // Use a vector so we can index into pts.
+                std::vector<NodeID> ptsVec;
+                for (const NodeID o : *pts) ptsVec.push_back(o);
+                for (size_t i = 0; i < ptsVec.size(); ++i)
+                {
+                    const NodeID oi = ptsVec[i];
+                    const Map<NodeID, unsigned>::const_iterator moi = nodeMap.find(oi);
+                    assert(moi != nodeMap.end());
+                    if (moi->second % numThreads != t) continue;
+                    for (size_t j = i + 1; j < ptsVec.size(); ++j)
+                    {
+                        const NodeID oj = ptsVec[j];
+                        const Map<NodeID, unsigned>::const_iterator moj = nodeMap.find(oj);
+                        assert(moj != nodeMap.end());
+                        updateDistance(distMatrix[condensedIndex(numObjects, moi->second, moj->second)], distance, occ);
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < numThreads; ++t) workers.push_back(std::thread(fillRows, t));
+        fillRows(0);
+        for (std::thread &t : workers) t.join();
+
+        const double clkEnd = PTAStat::getClk(true);
+        distanceMatrixTime += (clkEnd - clkStart) / TIMEINTERVAL;
+
+        return distMatrix;
+    }
 
+    std::vector<NodeID> NodeIDAllocator::Clusterer::getSparseSingleLinkageOrder(const std::vector<std::pair<const PointsTo *, unsigned>> &pointsToSets,
+                                                                                const size_t numObjects, const Map<NodeID, unsigned> &nodeMap)
+    {
+        // The entries of the distance matrix which are not the default, computed as getDistanceMatrix
+        // does (same points-to set order, same updates) so the distances are exactly the same.
+        const double defaultDistance = numObjects * numObjects;
+        Map<std::pair<unsigned, unsigned>, double> distances;
         for (const std::pair<const PointsTo *, unsigned> &ptsOcc : pointsToSets)
         {
             const PointsTo *pts = ptsOcc.first;
             assert(pts != nullptr);
-            const unsigned occ = ptsOcc.second;
+            const unsigned distance = requiredBits(*pts) / NATIVE_INT_SIZE;
 
-            // Distance between each element of pts.
-            unsigned distance = requiredBits(*pts) / NATIVE_INT_SIZE;
+            std::vector<unsigned> ptsVec;
+            for (const NodeID o : *pts)
+            {
+                const Map<NodeID, unsigned>::const_iterator mo = nodeMap.find(o);
+                assert(mo != nodeMap.end());
+                ptsVec.push_back(mo->second);
+            }
 
-            // Use a vector so we can index into pts.
-            std::vector<NodeID> ptsVec;
-            for (const NodeID o : *pts) ptsVec.push_back(o);
             for (size_t i = 0; i < ptsVec.size(); ++i)
             {
-                const NodeID oi = ptsVec[i];
-                const Map<NodeID, unsigned>::const_iterator moi = nodeMap.find(oi);
-                assert(moi != nodeMap.end());
                 for (size_t j = i + 1; j < ptsVec.size(); ++j)
                 {
-                    const NodeID oj = ptsVec[j];
-                    const Map<NodeID, unsigned>::const_iterator moj = nodeMap.find(oj);
-                    assert(moj != nodeMap.end());
-                    double &existingDistance = distMatrix[condensedIndex(numObjects, moi->second, moj->second)];
+                    const std::pair<unsigned, unsigned> pair = std::make_pair(std::min(ptsVec[i], ptsVec[j]), std::max(ptsVec[i], ptsVec[j]));
+                    updateDistance(distances.emplace(pair, defaultDistance).first->second, distance, ptsOcc.second);
+                }
+            }
+        }
 
-                    // Subtract extra occurrenceEpsilon to make upcoming logic simpler.
-                    // When existingDistance is never whole, it is always between two distances.
-                    if (distance < existingDistance) existingDistance = distance - occurrenceEpsilon;
+        std::vector<std::vector<std::pair<unsigned, double>>> neighbours(numObjects);
+        for (const Map<std::pair<unsigned, unsigned>, double>::value_type &pairDistance : distances)
+        {
+            neighbours[pairDistance.first.first].push_back(std::make_pair(pairDistance.first.second, pairDistance.second));
+            neighbours[pairDistance.first.second].push_back(std::make_pair(pairDistance.first.first, pairDistance.second));
+        }
+        distances.clear();
 
-                    if (distance == std::ceil(existingDistance))
-                    {
-                        // We have something like distance == x, existingDistance == x - e, for some e < 1
-                        // (potentially even set during this iteration).
-                        // So, the new distance is an occurrence the existingDistance being tracked, it just
-                        // had some reductions because of multiple occurences.
-                        // If there is not room within this distance to reduce more (increase priority),
-                        // just ignore it. TODO: maybe warn?
-                        if (existingDistance - occ * occurrenceEpsilon > std::floor(existingDistance))
-                        {
-                            existingDistance -= occ * occurrenceEpsilon;
-                        }
-                        else
-                        {
-                            // Reached minimum.
-                            existingDistance = std::floor(existingDistance) + occurrenceEpsilon;
-                        }
-                    }
+        // Minimum spanning tree as fastcluster's MST_linkage_core builds it: from object 0, the next
+        // object is the one closest to the tree, the lowest one on ties, and the edge recorded joins
+        // it to the previously added object.
+        std::vector<std::tuple<double, unsigned, unsigned>> edges;
+        std::vector<double> treeDistance(numObjects, defaultDistance);
+        std::set<std::pair<double, unsigned>> frontier;
+        for (unsigned i = 1; i < numObjects; ++i) frontier.insert(std::make_pair(defaultDistance, i));
+        unsigned prev = 0;
+        while (!frontier.empty())
+        {
+            for (const std::pair<unsigned, double> &neighbour : neighbours[prev])
+            {
+                const unsigned o = neighbour.first;
+                if (neighbour.second < treeDistance[o] && frontier.erase(std::make_pair(treeDistance[o], o)) != 0)
+                {
+                    treeDistance[o] = neighbour.second;
+                    frontier.insert(std::make_pair(treeDistance[o], o));
                 }
             }
 
+            const std::pair<double, unsigned> closest = *frontier.begin();
+            frontier.erase(frontier.begin());
+            edges.push_back(std::make_tuple(closest.first, prev, closest.second));
+            prev = closest.second;
         }
 
-        const double clkEnd = PTAStat::getClk(true);
-        distanceMatrixTime += (clkEnd - clkStart) / TIMEINTERVAL;
+        std::stable_sort(edges.begin(), edges.end(),
+                         [](const std::tuple<double, unsigned, unsigned> &e1, const std::tuple<double, unsigned, unsigned> &e2)
+                         { return std::get<0>(e1) < std::get<0>(e2); });
 
-        return distMatrix;
+        // Union-find where each cluster also keeps its objects in a list. As in fastcluster's
+        // dendrogram, the ith merge creates cluster numObjects + i and the cluster with the lower
+        // identifier is the left child, so merging appends the right cluster's list to the left
+        // one's, which is the order the leaves would be visited in by traverseDendrogram.
+        std::vector<unsigned> parent(numObjects);
+        std::vector<unsigned> clusterId(numObjects);
+        std::vector<unsigned> head(numObjects);
+        std::vector<unsigned> tail(numObjects);
+        std::vector<unsigned> next(numObjects, UINT_MAX);
+        for (size_t i = 0; i < numObjects; ++i) parent[i] = clusterId[i] = head[i] = tail[i] = i;
+
+        auto find = [&parent](unsigned i)
+        {
+            while (parent[i] != i)
+            {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        };
+
+        unsigned merges = 0;
+        for (const std::tuple<double, unsigned, unsigned> &edge : edges)
+        {
+            unsigned c1 = find(std::get<1>(edge));
+            unsigned c2 = find(std::get<2>(edge));
+            assert(c1 != c2 && "Clusterer::getSparseSingleLinkageOrder: spanning tree edge within a cluster");
+            if (clusterId[c1] > clusterId[c2]) std::swap(c1, c2);
+            next[tail[c1]] = head[c2];
+            tail[c1] = tail[c2];
+            parent[c2] = c1;
+            clusterId[c1] = numObjects + merges++;
+        }
+
+        std::vector<NodeID> order(numObjects, UINT_MAX);
+        unsigned position = 0;
+        for (unsigned o = head[find(0)]; o != UINT_MAX; o = next[o]) order[o] = position++;
+        assert(position == numObjects && "Clusterer::getSparseSingleLinkageOrder: objects left out of the dendrogram");
+
+        return order;
     }
 
     void NodeIDAllocator::Clusterer::traverseDendrogram(std::vector<NodeID> &nodeMap, const int *dendrogram, const size_t numObjects, unsigned &allocCounter, Set<int> &visited, const int index, const std::vector<NodeID> &regionNodeMap)
@@ -639,7 +859,7 @@ namespace SVF
         // Work out which of the mappings we generated looks best.
     std::pair<hclust_fast_methods, std::vector<NodeID>> NodeIDAllocator::Clusterer::determineBestMapping(
             const std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> &candidates,
-            Map<PointsTo, unsigned> pointsToSets, const std::string &evalSubtitle, double &evalTime)
+            Map<PointsTo, unsigned> pointsToSets, const std::string &evalSubtitle, double &evalTime, StatsList *deferredStats)
     {
         // In case we're not comparing anything, set to first "candidate".
         std::pair<hclust_fast_methods, std::vector<NodeID>> bestMapping = candidates[0];
@@ -647,24 +867,42 @@ namespace SVF
         size_t bestWords = std::numeric_limits<size_t>::max();
         if (evalSubtitle != "" || Options::ClusterMethod == HCLUST_METHOD_SVF_BEST)
         {
-            for (const std::pair<hclust_fast_methods, std::vector<NodeID>> &candidate : candidates)
+            // Candidates are evaluated concurrently, then reported and compared in order.
+            std::vector<Map<std::string, std::string>> candidatesStats(candidates.size());
+            std::vector<double> candidatesEvalTime(candidates.size(), 0.0);
+            auto evaluateCandidate = [&](size_t c)
             {
-                Map<std::string, std::string> candidateStats;
-                hclust_fast_methods candidateMethod = candidate.first;
-                std::string candidateMethodName = SVFUtil::hclustMethodToString(candidateMethod);
-                std::vector<NodeID> candidateMapping = candidate.second;
-
                 // TODO: parameterise final arg.
                 const double clkStart = PTAStat::getClk(true);
-                evaluate(candidateMapping, pointsToSets, candidateStats, true);
+                evaluate(candidates[c].second, pointsToSets, candidatesStats[c], true);
                 const double clkEnd = PTAStat::getClk(true);
-                evalTime += (clkEnd - clkStart) / TIMEINTERVAL;
-                printStats(evalSubtitle + ": candidate " + candidateMethodName, candidateStats);
+                candidatesEvalTime[c] = (clkEnd - clkStart) / TIMEINTERVAL;
+            };
+
+            // At most -cluster-threads evaluators (including this thread) pull candidates.
+            const u32_t numThreads = std::max(1u, std::min<u32_t>(Options::ClusterThreads, candidates.size()));
+            std::atomic<u32_t> nextCandidate(0);
+            auto evaluateCandidates = [&](void)
+            {
+                for (u32_t c = nextCandidate++; c < candidates.size(); c = nextCandidate++) evaluateCandidate(c);
+            };
+
+            std::vector<std::thread> evaluators;
+            for (u32_t t = 1; t < numThreads; ++t) evaluators.push_back(std::thread(evaluateCandidates));
+            evaluateCandidates();
+            for (std::thread &t : evaluators) t.join();
+
+            for (size_t c = 0; c < candidates.size(); ++c)
+            {
+                const std::pair<hclust_fast_methods, std::vector<NodeID>> &candidate = candidates[c];
+                Map<std::string, std::string> &candidateStats = candidatesStats[c];
+                hclust_fast_methods candidateMethod = candidate.first;
+                std::string candidateMethodName = SVFUtil::hclustMethodToString(candidateMethod);
 
-                size_t candidateWords = 0;
-                if (Options::PtType == PointsTo::SBV) candidateWords = std::stoull(candidateStats[NewSbvNumWords]);
-                else if (Options::PtType == PointsTo::CBV) candidateWords = std::stoull(candidateStats[NewBvNumWords]);
-                else assert(false && "Clusterer::cluster: unsupported BV type for clustering.");
+                evalTime += candidatesEvalTime[c];
+                printOrDeferStats(evalSubtitle + ": candidate " + candidateMethodName, candidateStats, deferredStats);
+
+                size_t candidateWords = getNewNumWords(candidateStats);
 
                 if (candidateWords < bestWords)
                 {
@@ -677,13 +915,27 @@ namespace SVF
         return bestMapping;
     }
 
+    u64_t NodeIDAllocator::Clusterer::getNewNumWords(Map<std::string, std::string> &stats)
+    {
+        if (Options::PtType == PointsTo::SBV) return std::stoull(stats[NewSbvNumWords]);
+        else if (Options::PtType == PointsTo::CBV) return std::stoull(stats[NewBvNumWords]);
+        assert(false && "Clusterer::cluster: unsupported BV type for clustering.");
+        return 0;
+    }
+
+    void NodeIDAllocator::Clusterer::printOrDeferStats(const std::string &subtitle, Map<std::string, std::string> &stats, StatsList *deferredStats)
+    {
+        if (deferredStats != nullptr) deferredStats->push_back(std::make_pair(subtitle, stats));
+        else printStats(subtitle, stats);
+    }
+
     void NodeIDAllocator::Clusterer::printStats(std::string subtitle, Map<std::string, std::string> &stats)
     {
         // When not in order, it is too hard to compare original/new SBV/BV words, so this array forces an order.
-        const static std::array<std::string, 17> statKeys =
+        const static std::array<std::string, 20> statKeys =
             { NumObjects, TheoreticalNumWords, OriginalSbvNumWords, OriginalBvNumWords,
-              NewSbvNumWords, NewBvNumWords, NumRegions, NumGtIntRegions,
-              NumNonTrivialRegionObjects, LargestRegion, RegioningTime,
+              NewSbvNumWords, NewBvNumWords, RemapOldWords, RemapSavedBits, NumRegions, NumGtIntRegions,
+              NumNonTrivialRegionObjects, NumSparseRegions, LargestRegion, RegioningTime,
               DistanceMatrixTime, FastClusterTime, DendrogramTraversalTime,
               EvalTime, TotalTime, BestCandidate };
 
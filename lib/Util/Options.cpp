@@ -314,6 +314,12 @@ namespace SVF
         llvm::cl::desc("Dump dot graph of Call Graph")
     );
 
+    const llvm::cl::opt<unsigned> Options::TCTThreads(
+        "tct-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads used to precompute loop/dominator info and expand thread contexts when building the TCT")
+    );
+
     const llvm::cl::opt<bool> Options::PAGPrint(
         "print-pag", 
         llvm::cl::init(false),
@@ -370,6 +376,12 @@ namespace SVF
         llvm::cl::desc("Cluster for FS/VFS with auxiliary Andersen's")
     );
 
+    const llvm::cl::opt<unsigned> Options::ClusterFsOnline(
+        "cluster-fs-online",
+        llvm::cl::init(0),
+        llvm::cl::desc("With -cluster-fs, re-cluster in the background every given number of processed SVFG nodes (0: never)")
+    );
+
     const llvm::cl::opt<bool> Options::PlainMappingFs(
         "plain-mapping-fs",
         llvm::cl::init(false),
@@ -419,6 +431,18 @@ namespace SVF
         llvm::cl::desc("try to predict which points-to sets are more important in staged analysis")
     );
 
+    const llvm::cl::opt<unsigned> Options::ClusterThreads(
+        "cluster-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("number of threads clustering regions and evaluating candidate methods")
+    );
+
+    const llvm::cl::opt<unsigned> Options::ClusterMaxMatrixObjects(
+        "cluster-max-matrix-objects",
+        llvm::cl::init(8192),
+        llvm::cl::desc("regions with more objects use sparse single linkage instead of a distance matrix (0: no limit)")
+    );
+
     // Memory region (MemRegion.cpp)
     const llvm::cl::opt<bool> Options::IgnoreDeadFun(
         "mssa-ignore-dead-fun", 
@@ -496,6 +520,12 @@ namespace SVF
         llvm::cl::desc("Add thread SVFG edges with models: 0 Non Add Edge; 1 NonSparse; 2 All Optimisation; 3 No MHP; 4 No Alias; 5 No Lock; 6 No Read Precision.")
     );
 
+    const llvm::cl::opt<unsigned> Options::TDEdgeThreads(
+        "td-edge-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads used to pair stores and loads accessing common objects when adding thread SVFG edges")
+    );
+
 
     // LockAnalysis.cpp
     const llvm::cl::opt<bool> Options::PrintLockSpan(
@@ -518,6 +548,24 @@ namespace SVF
         llvm::cl::desc("Run Lock Analysis")
     );
 
+    const llvm::cl::opt<unsigned> Options::MHPThreads(
+        "mhp-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads used to solve MHP thread interleavings (threads at the same TCT depth are solved concurrently)")
+    );
+
+    const llvm::cl::opt<bool> Options::MHPQueryClasses(
+        "mhp-query-classes",
+        llvm::cl::init(true),
+        llvm::cl::desc("Answer MHP queries from a precomputed matrix between interleaving classes of instructions")
+    );
+
+    const llvm::cl::opt<bool> Options::MHPPCGPrefilter(
+        "mhp-pcg-prefilter",
+        llvm::cl::init(true),
+        llvm::cl::desc("Consult the procedure-level MHP (PCG) before answering MHP queries context-sensitively")
+    );
+
 
     // MTA.cpp
     const llvm::cl::opt<bool> Options::AndersenAnno(
@@ -563,6 +611,26 @@ namespace SVF
     );
 
 
+    // MTAReportSink.cpp
+    const llvm::cl::opt<std::string> Options::MTAReportFile(
+        "mta-report",
+        llvm::cl::init(""),
+        llvm::cl::desc("Stream MHP/lock/race/validation results line by line into the given file (racy accesses are then not kept for annotation)")
+    );
+
+    const llvm::cl::opt<unsigned> Options::MTAReportFlushMs(
+        "mta-report-flush-ms",
+        llvm::cl::init(1000),
+        llvm::cl::desc("Write out buffered -mta-report results at least every given milliseconds")
+    );
+
+    const llvm::cl::opt<unsigned> Options::MTAReportBufferSize(
+        "mta-report-buffer",
+        llvm::cl::init(64),
+        llvm::cl::desc("Size (KB) of the buffer holding -mta-report results before they are written out")
+    );
+
+
     // PCG.cpp
     //const llvm::cl::opt<bool> TDPrint(
         // "print-td",
@@ -615,6 +683,12 @@ namespace SVF
         llvm::cl::desc("print the DCHG if debug information is available")
     );
 
+    const llvm::cl::opt<unsigned> Options::DCHGThreads(
+        "dchg-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads flattening the struct/class types and gathering the aggregates of the DCHG")
+    );
+
 
     // LLVMModule.cpp
     const llvm::cl::opt<std::string> Options::Graphtxt(
@@ -629,6 +703,32 @@ namespace SVF
         llvm::cl::desc("add svf.main()")
     );
 
+    const llvm::cl::opt<unsigned> Options::LoadThreads(
+        "load-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads reading the input modules")
+    );
+
+    const llvm::cl::opt<bool> Options::LazyLoad(
+        "lazy-load",
+        llvm::cl::init(false),
+        llvm::cl::desc("Load modules lazily and only materialize the functions reachable from main")
+    );
+
+    // ICFGBuilder.cpp
+    const llvm::cl::opt<unsigned> Options::ICFGBuildThreads(
+        "icfg-build-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads building the intra-procedural ICFG of functions")
+    );
+
+    // SVFIRBuilder.cpp
+    const llvm::cl::opt<unsigned> Options::PAGBuildThreads(
+        "pag-build-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads collecting the SVFIR statements of functions")
+    );
+
     const llvm::cl::opt<bool> Options::ModelConsts(
         "model-consts", 
         llvm::cl::init(false),
@@ -640,6 +740,12 @@ namespace SVF
             llvm::cl::desc("Print Symbol Table to command line")
     );
 
+    const llvm::cl::opt<unsigned> Options::SymTabThreads(
+        "symtab-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads collecting the symbols of functions and the field info of struct types")
+    );
+
 
     // Conditions.cpp
     const llvm::cl::opt<unsigned> Options::MaxBddSize(
@@ -648,6 +754,54 @@ namespace SVF
         llvm::cl::desc("Maximum context limit for DDA")
     );
 
+    const llvm::cl::opt<bool> Options::IncrementalSat(
+        "incremental-sat",
+        llvm::cl::init(true),
+        llvm::cl::desc("Check path conditions incrementally, reusing solver scopes of shared conjuncts")
+    );
+
+    const llvm::cl::opt<std::string> Options::BddReorder(
+        "bdd-reorder",
+        llvm::cl::init("none"),
+        llvm::cl::desc("Dynamic BDD variable reordering: none, sift, sift-conv, symm-sift, window2, window3, window4")
+    );
+
+    const llvm::cl::opt<unsigned> Options::BddReorderThreshold(
+        "bdd-reorder-threshold",
+        llvm::cl::init(0),
+        llvm::cl::desc("Number of BDD nodes triggering the first dynamic reordering (0: CUDD default)")
+    );
+
+    const llvm::cl::opt<bool> Options::BddGC(
+        "bdd-gc",
+        llvm::cl::init(true),
+        llvm::cl::desc("Enable garbage collection of dead BDD nodes")
+    );
+
+    const llvm::cl::opt<unsigned> Options::BddMaxMem(
+        "bdd-max-mem",
+        llvm::cl::init(0),
+        llvm::cl::desc("Target maximum memory (MB) of the BDD manager, which decides its table growth and garbage collection (0: CUDD default)")
+    );
+
+    const llvm::cl::opt<unsigned> Options::BddGCFrac(
+        "bdd-gc-frac",
+        llvm::cl::init(0),
+        llvm::cl::desc("Initial percentage of dead BDD nodes in the unique table triggering garbage collection, adapted by CUDD as the table grows (0: CUDD default)")
+    );
+
+    const llvm::cl::opt<unsigned> Options::BddMinHit(
+        "bdd-min-hit",
+        llvm::cl::init(0),
+        llvm::cl::desc("Minimum BDD computed table hit rate (percentage) for the table to grow (0: CUDD default)")
+    );
+
+    const llvm::cl::opt<unsigned> Options::BddLooseUpTo(
+        "bdd-loose-up-to",
+        llvm::cl::init(0),
+        llvm::cl::desc("Number of BDD unique table slots up to which the table grows fast rather than garbage collects (0: derived from -bdd-max-mem)")
+    );
+
     
     // PathCondAllocator.cpp
     const llvm::cl::opt<bool> Options::PrintPathCond(
@@ -656,6 +810,24 @@ namespace SVF
         llvm::cl::desc("Print out path condition")
     );
 
+    const llvm::cl::opt<std::string> Options::BddVarOrder(
+        "bdd-var-order",
+        llvm::cl::init("layout"),
+        llvm::cl::desc("Order of allocating branch condition variables in a function: layout, dom (dominator tree preorder), rpo (reverse post-order)")
+    );
+
+    const llvm::cl::opt<bool> Options::LazyPathCond(
+        "lazy-pc",
+        llvm::cl::init(false),
+        llvm::cl::desc("Allocate path conditions of a function when a guard computation first reaches it")
+    );
+
+    const llvm::cl::opt<unsigned> Options::PathCondThreads(
+        "path-cond-threads",
+        llvm::cl::init(1),
+        llvm::cl::desc("Number of threads allocating path conditions, each with its own condition manager")
+    );
+
 
     // SVFUtil.cpp
     const llvm::cl::opt<bool> Options::DisableWarn(
@@ -664,6 +836,19 @@ namespace SVF
         llvm::cl::desc("Disable warning")
     );
 
+    // ExtAPI.cpp
+    const llvm::cl::opt<std::string> Options::ExtAPISpec(
+        "ext-api-spec",
+        llvm::cl::init(""),
+        llvm::cl::desc("File of extra external function summaries, one \"<function> <EFT_kind>\" per line")
+    );
+
+    const llvm::cl::opt<std::string> Options::ExtAPISpecCache(
+        "ext-api-spec-cache",
+        llvm::cl::init(""),
+        llvm::cl::desc("Binary cache of the compiled -ext-api-spec, rebuilt when the spec changes (none by default)")
+    );
+
     
     // Andersen.cpp
     const llvm::cl::opt<bool> Options::ConsCGDotGraph(
@@ -702,6 +887,12 @@ namespace SVF
         llvm::cl::desc("Disable diff pts propagation")
     );
 
+    const llvm::cl::opt<bool> Options::AnderOVS(
+        "ander-ovs",
+        llvm::cl::init(false),
+        llvm::cl::desc("Merge pointer-equivalent constraint nodes by offline variable substitution (HU) before Andersen's solving")
+    );
+
     const llvm::cl::opt<bool> Options::MergePWC(
         "merge-pwc",  
         llvm::cl::init(true),
@@ -716,6 +907,12 @@ namespace SVF
         llvm::cl::desc("Prints alias evaluation of ctir instructions in FS analyses")
     );
 
+    const llvm::cl::opt<bool> Options::FsCollapseCopySCC(
+        "fs-collapse-copy-scc",
+        llvm::cl::init(false),
+        llvm::cl::desc("Collapse cycles of top-level copies/phis (within an Andersen's SCC) on the SVFG before flow-sensitive solving")
+    );
+
     
     // FlowSensitiveTBHC.cpp
     /// Whether we allow reuse for TBHC.
@@ -46,6 +46,8 @@ Size_t AndersenBase::numOfProcessedStore = 0;
 Size_t AndersenBase::numOfSfrs = 0;
 Size_t AndersenBase::numOfFieldExpand = 0;
 
+Size_t AndersenBase::numOfSubstitutedNodes = 0;
+
 Size_t AndersenBase::numOfSCCDetection = 0;
 double AndersenBase::timeOfSCCDetection = 0;
 double AndersenBase::timeOfSCCMerges = 0;
@@ -191,12 +193,64 @@ void Andersen::initialize()
     setPWCOpt(Options::MergePWC);
     AndersenBase::initialize();
 
+    if (Options::AnderOVS) substituteOfflineEquivalence();
+
     if (Options::ClusterAnder) cluster();
 
     /// Initialize worklist
     processAllAddr();
 }
 
+/*!
+ * Offline variable substitution
+ */
+void Andersen::substituteOfflineEquivalence()
+{
+    /// Nodes receiving copy edges when the call graph is updated
+    NodeBS onlineNodes;
+    for (SVFIR::FunToArgsListMap::const_iterator it = pag->getFunArgsMap().begin(),
+            eit = pag->getFunArgsMap().end(); it != eit; ++it)
+    {
+        for (const SVFVar* arg : it->second)
+            onlineNodes.set(arg->getId());
+        if (it->first->isVarArg())
+            onlineNodes.set(pag->getVarargNode(it->first));
+    }
+    for (CallSiteToFunPtrMap::const_iterator it = getIndirectCallsites().begin(),
+            eit = getIndirectCallsites().end(); it != eit; ++it)
+    {
+        const RetBlockNode* retBlockNode = pag->getICFG()->getRetBlockNode(it->first->getCallSite());
+        if (pag->callsiteHasRet(retBlockNode))
+            onlineNodes.set(pag->getCallSiteRet(retBlockNode)->getId());
+    }
+    /// Objects receive copy edges from stores
+    for (SVFIR::iterator it = pag->begin(), eit = pag->end(); it != eit; ++it)
+    {
+        if (SVFUtil::isa<ObjVar>(it->second))
+            onlineNodes.set(it->first);
+    }
+
+    OfflineConsG* oCG = new OfflineConsG(pag);
+    SCCDetection<OfflineConsG*>* oscc = new SCCDetection<OfflineConsG*>(oCG);
+    oscc->find();
+    oCG->solvePointerEquivalence(oscc, onlineNodes);
+
+    const OfflineConsG::NodeToRepMap& peRepMap = oCG->getPERepMap();
+    for (OfflineConsG::NodeToRepMap::const_iterator it = peRepMap.begin(), eit = peRepMap.end(); it != eit; ++it)
+    {
+        NodeID node = sccRepNode(it->first);
+        NodeID rep = sccRepNode(it->second);
+        if (node != rep && consCG->hasConstraintNode(node) && consCG->hasConstraintNode(rep))
+        {
+            mergeNodeToRep(node, rep);
+            numOfSubstitutedNodes++;
+        }
+    }
+
+    delete oscc;
+    delete oCG;
+}
+
 /*!
  * Finalize analysis
  */
@@ -335,6 +335,7 @@ void AndersenStat::performStat()
 
     PTNumStatMap[NumOfSfr] = Andersen::numOfSfrs;
     PTNumStatMap[NumOfFieldExpand] = Andersen::numOfFieldExpand;
+    PTNumStatMap["NumOfSubstitutedNodes"] = Andersen::numOfSubstitutedNodes;
 
     PTNumStatMap[NumOfPointers] = pag->getValueNodeNum();
     PTNumStatMap[NumOfMemObjects] = pag->getObjectNodeNum();
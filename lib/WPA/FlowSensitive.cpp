@@ -33,8 +33,10 @@
 #include "Util/TypeBasedHeapCloning.h"
 #include "WPA/WPAStat.h"
 #include "WPA/FlowSensitive.h"
+#include "Graphs/SVFGStat.h"
 #include "WPA/Andersen.h"
 #include "MemoryModel/PointsTo.h"
+#include <thread>
 
 
 using namespace SVF;
@@ -78,10 +80,218 @@ void FlowSensitive::initialize()
     else
         svfg = memSSA.buildPTROnlySVFGWithoutOPT(ander);
 
+    /// Subclasses (versioned, TBHC) access top-level points-to sets without going through
+    /// the representatives, so collapsing is only done for the plain flow-sensitive analysis.
+    if (Options::FsCollapseCopySCC && getAnalysisTy() == FSSPARSE_WPA)
+        collapseTopLevelCopySCCs();
+
     setGraph(svfg);
     //AndersenWaveDiff::releaseAndersenWaveDiff();
 }
 
+/*!
+ * Collapse cycles of top-level copies/phis on the SVFG
+ */
+void FlowSensitive::collapseTopLevelCopySCCs()
+{
+    /// Value-flow edges q --> p of copies/phis p = q whose operands are in the same SCC
+    /// of Andersen's constraint graph. Every top-level variable of a cycle of such edges
+    /// is defined by a copy/phi, so the cycle is an exact equality of points-to sets.
+    Map<NodeID, NodeBS> copySuccs;
+    for (SVFG::iterator it = svfg->begin(), eit = svfg->end(); it != eit; ++it)
+    {
+        const SVFGNode* node = it->second;
+        if (const CopySVFGNode* copy = SVFUtil::dyn_cast<CopySVFGNode>(node))
+        {
+            NodeID src = copy->getPAGSrcNodeID();
+            NodeID dst = copy->getPAGDstNodeID();
+            if (src != dst && ander->sccRepNode(src) == ander->sccRepNode(dst))
+            {
+                copySuccs[src].set(dst);
+                copySuccs[dst];
+            }
+        }
+        else if (const IntraPHISVFGNode* phi = SVFUtil::dyn_cast<IntraPHISVFGNode>(node))
+        {
+            NodeID dst = phi->getRes()->getId();
+            for (PHISVFGNode::OPVers::const_iterator opIt = phi->opVerBegin(), opEit = phi->opVerEnd();
+                    opIt != opEit; ++opIt)
+            {
+                NodeID src = opIt->second->getId();
+                if (src != dst && ander->sccRepNode(src) == ander->sccRepNode(dst))
+                {
+                    copySuccs[src].set(dst);
+                    copySuccs[dst];
+                }
+            }
+        }
+    }
+
+    /// Tarjan's SCC detection over the copy edges (iterative, the chains can be long)
+    std::vector<NodeBS> sccs;
+    Map<NodeID, u32_t> dfn, low;
+    NodeBS onStack;
+    std::vector<NodeID> sccStack;
+    std::vector<std::pair<NodeID, NodeBS::iterator>> dfsStack;
+    u32_t index = 0;
+    auto visit = [&](NodeID v)
+    {
+        dfn[v] = low[v] = index++;
+        sccStack.push_back(v);
+        onStack.set(v);
+        dfsStack.push_back(std::make_pair(v, copySuccs[v].begin()));
+    };
+    for (Map<NodeID, NodeBS>::const_iterator it = copySuccs.begin(), eit = copySuccs.end(); it != eit; ++it)
+    {
+        if (dfn.find(it->first) != dfn.end())
+            continue;
+        visit(it->first);
+        while (!dfsStack.empty())
+        {
+            NodeID v = dfsStack.back().first;
+            NodeBS::iterator& succIt = dfsStack.back().second;
+            if (succIt != copySuccs[v].end())
+            {
+                NodeID w = *succIt;
+                ++succIt;
+                if (dfn.find(w) == dfn.end())
+                    visit(w);
+                else if (onStack.test(w))
+                    low[v] = std::min(low[v], dfn[w]);
+                continue;
+            }
+
+            dfsStack.pop_back();
+            if (!dfsStack.empty())
+            {
+                NodeID u = dfsStack.back().first;
+                low[u] = std::min(low[u], low[v]);
+            }
+            if (low[v] == dfn[v])
+            {
+                NodeBS scc;
+                NodeID w;
+                do
+                {
+                    w = sccStack.back();
+                    sccStack.pop_back();
+                    onStack.reset(w);
+                    scc.set(w);
+                }
+                while (w != v);
+                if (scc.count() > 1)
+                    sccs.push_back(scc);
+            }
+        }
+    }
+
+    u32_t numOfVars = 0, numOfNodes = 0;
+    s32_t numOfEdges = 0;
+    for (const NodeBS& scc : sccs)
+    {
+        /// Definitions of the merged variables: copies/phis with all operands in the
+        /// cycle are removed, the others are kept as they bring in new points-to targets.
+        NodeBS removed, kept;
+        const SVFFunction* fun = nullptr;
+        bool sameFun = true;
+        for (NodeID var : scc)
+        {
+            const SVFGNode* def = svfg->getDefSVFGNode(pag->getGNode(var));
+            if (fun == nullptr)
+                fun = def->getFun();
+            else if (def->getFun() != fun)
+                sameFun = false;
+
+            bool removable = true;
+            if (const IntraPHISVFGNode* phi = SVFUtil::dyn_cast<IntraPHISVFGNode>(def))
+            {
+                for (PHISVFGNode::OPVers::const_iterator opIt = phi->opVerBegin(), opEit = phi->opVerEnd();
+                        opIt != opEit; ++opIt)
+                {
+                    if (!scc.test(opIt->second->getId()))
+                        removable = false;
+                }
+            }
+            if (removable)
+                removed.set(def->getId());
+            else
+                kept.set(def->getId());
+        }
+        /// Intra value-flow edges can not be added across functions
+        if (!sameFun)
+            continue;
+        /// A cycle without incoming value-flow never points to anything, keep one definition anyway
+        if (kept.empty())
+        {
+            NodeID first = removed.find_first();
+            removed.reset(first);
+            kept.set(first);
+        }
+
+        /// Connect every kept definition to the uses of all merged variables
+        for (NodeID var : scc)
+        {
+            const SVFGNode* def = svfg->getDefSVFGNode(pag->getGNode(var));
+            for (SVFGNode::const_iterator eit = def->OutEdgeBegin(), eeit = def->OutEdgeEnd(); eit != eeit; ++eit)
+            {
+                const SVFGEdge* edge = *eit;
+                NodeID dst = edge->getDstID();
+                if (removed.test(dst) || kept.test(dst))
+                    continue;
+                for (NodeID k : kept)
+                {
+                    if (k == def->getId())
+                        continue;
+                    SVFGEdge* newEdge = nullptr;
+                    if (const CallDirSVFGEdge* callEdge = SVFUtil::dyn_cast<CallDirSVFGEdge>(edge))
+                        newEdge = svfg->addCallEdge(k, dst, callEdge->getCallSiteId());
+                    else if (const RetDirSVFGEdge* retEdge = SVFUtil::dyn_cast<RetDirSVFGEdge>(edge))
+                        newEdge = svfg->addRetEdge(k, dst, retEdge->getCallSiteId());
+                    else
+                    {
+                        assert(SVFUtil::isa<IntraDirSVFGEdge>(edge) && "expecting a direct edge from a top-level definition");
+                        newEdge = svfg->addIntraDirectVFEdge(k, dst);
+                    }
+                    if (newEdge != nullptr)
+                        numOfEdges--;
+                }
+            }
+        }
+
+        NodeID rep = scc.find_first();
+        for (NodeID var : scc)
+        {
+            topLevelRep[var] = rep;
+            if (removed.test(svfg->getDefSVFGNode(pag->getGNode(var))->getId()))
+                svfg->resetDef(pag->getGNode(var), svfg->getSVFGNode(kept.find_first()));
+        }
+        repToCollapsedDefs[rep] = kept;
+        for (NodeID k : kept)
+            collapsedDefToRep[k] = rep;
+
+        for (NodeID r : removed)
+        {
+            SVFGNode* node = svfg->getSVFGNode(r);
+            SVFGEdgeSetTy edges;
+            edges.insert(node->InEdgeBegin(), node->InEdgeEnd());
+            edges.insert(node->OutEdgeBegin(), node->OutEdgeEnd());
+            for (SVFGEdge* edge : edges)
+            {
+                svfg->removeSVFGEdge(edge);
+                numOfEdges++;
+            }
+            svfg->removeSVFGNode(node);
+        }
+
+        numOfVars += scc.count();
+        numOfNodes += removed.count();
+    }
+
+    svfg->getStat()->collapsedTopLevelSCCs(numOfVars, numOfNodes, numOfEdges > 0 ? numOfEdges : 0);
+    if (printStat())
+        svfg->performStat();
+}
+
 /*!
  * Start analysis
  */
@@ -150,6 +360,19 @@ void FlowSensitive::finalize()
         }
     }
 
+    // A background clustering still running is of no use anymore.
+    cancelOnlineCluster();
+
+    // Give the variables merged into a representative their points-to sets back.
+    for (NodeToNodeMap::const_iterator it = topLevelRep.begin(), eit = topLevelRep.end(); it != eit; ++it)
+    {
+        if (it->first != it->second)
+        {
+            PointsTo repPts = BVDataPTAImpl::getPts(it->second);
+            BVDataPTAImpl::unionPts(it->first, repPts);
+        }
+    }
+
     // TODO: check -stat too.
     if (Options::ClusterFs)
     {
@@ -195,6 +418,8 @@ void FlowSensitive::processNode(NodeID nodeId)
         propagate(&node);
 
     clearAllDFOutVarFlag(node);
+
+    reclusterOnline();
 }
 
 /*!
@@ -717,6 +942,31 @@ void FlowSensitive::connectCallerAndCallee(const CallEdgeMap& newEdges, SVFGEdge
             svfg->connectCallerAndCallee(cs, func, edges);
         }
     }
+
+    /// A use connected to one definition of collapsed variables is a use of all of them
+    if (collapsedDefToRep.empty())
+        return;
+    SVFGEdgeSetTy collapsedEdges;
+    for (SVFGEdgeSetTy::const_iterator it = edges.begin(), eit = edges.end(); it != eit; ++it)
+    {
+        const SVFGEdge* edge = *it;
+        NodeToNodeMap::const_iterator repIt = collapsedDefToRep.find(edge->getSrcID());
+        if (repIt == collapsedDefToRep.end() || !edge->isDirectVFGEdge())
+            continue;
+        for (NodeID k : repToCollapsedDefs[repIt->second])
+        {
+            if (k == edge->getSrcID() || k == edge->getDstID())
+                continue;
+            SVFGEdge* newEdge = nullptr;
+            if (const CallDirSVFGEdge* callEdge = SVFUtil::dyn_cast<CallDirSVFGEdge>(edge))
+                newEdge = svfg->addCallEdge(k, edge->getDstID(), callEdge->getCallSiteId());
+            else if (const RetDirSVFGEdge* retEdge = SVFUtil::dyn_cast<RetDirSVFGEdge>(edge))
+                newEdge = svfg->addRetEdge(k, edge->getDstID(), retEdge->getCallSiteId());
+            if (newEdge != nullptr)
+                collapsedEdges.insert(newEdge);
+        }
+    }
+    edges.insert(collapsedEdges.begin(), collapsedEdges.end());
 }
 
 /*!
@@ -803,6 +1053,81 @@ void FlowSensitive::cluster(void)
     PointsTo::setCurrentBestNodeMapping(nodeMapping, reverseNodeMapping);
 }
 
+void FlowSensitive::reclusterOnline(void)
+{
+    if (!Options::ClusterFs || Options::ClusterFsOnline == 0) return;
+    if (++numOfProcessedSinceRecluster < Options::ClusterFsOnline) return;
+    numOfProcessedSinceRecluster = 0;
+
+    if (onlineCluster.valid())
+    {
+        // Keep solving with the current mapping until the background clustering is done.
+        if (onlineCluster.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        {
+            onlineClusterThread.join();
+            applyOnlineCluster();
+        }
+        return;
+    }
+
+    // Copies of the points-to sets, so the clustering does not race with solving.
+    Map<PointsTo, unsigned> allPts = getPTDataTy()->getAllPts(true);
+    PointsTo::MappingPtr currentMapping = PointsTo::getCurrentBestNodeMapping();
+    const std::string subtitle = "online-" + std::to_string(numOfOnlineRemaps + 1);
+    onlineClusterCancelled.store(false);
+    const std::atomic<bool> *cancelled = &onlineClusterCancelled;
+    // The thread only touches its own copies; it is joined before the result is used or the analysis ends.
+    std::packaged_task<OnlineClusterResult(void)> task([allPts = std::move(allPts), currentMapping, subtitle, cancelled](void)
+    {
+        OnlineClusterResult result;
+        std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> candidates;
+        result.mapping = NodeIDAllocator::Clusterer::cluster(allPts, candidates, subtitle, &result.clusterStats, cancelled);
+        if (cancelled->load()) return result;
+
+        NodeIDAllocator::Clusterer::evaluate(*currentMapping, allPts, result.stats, true);
+        result.oldWords = NodeIDAllocator::Clusterer::getNewNumWords(result.stats);
+        if (cancelled->load()) return result;
+        NodeIDAllocator::Clusterer::evaluate(result.mapping, allPts, result.stats, true);
+        result.newWords = NodeIDAllocator::Clusterer::getNewNumWords(result.stats);
+        return result;
+    });
+    onlineCluster = task.get_future();
+    onlineClusterThread = std::thread(std::move(task));
+}
+
+void FlowSensitive::cancelOnlineCluster(void)
+{
+    if (!onlineClusterThread.joinable()) return;
+    onlineClusterCancelled.store(true);
+    onlineClusterThread.join();
+    onlineCluster = std::future<OnlineClusterResult>();
+}
+
+void FlowSensitive::applyOnlineCluster(void)
+{
+    OnlineClusterResult result = onlineCluster.get();
+    ++numOfOnlineRemaps;
+
+    for (std::pair<std::string, Map<std::string, std::string>> &clusterStats : result.clusterStats)
+        NodeIDAllocator::Clusterer::printStats(clusterStats.first, clusterStats.second);
+
+    // Only remap when it pays off for the points-to sets seen so far.
+    const bool remap = result.newWords < result.oldWords;
+    if (remap)
+    {
+        PointsTo::MappingPtr nodeMapping = std::make_shared<std::vector<NodeID>>(std::move(result.mapping));
+        PointsTo::MappingPtr reverseNodeMapping =
+            std::make_shared<std::vector<NodeID>>(NodeIDAllocator::Clusterer::getReverseNodeMapping(*nodeMapping));
+        PointsTo::setCurrentBestNodeMapping(nodeMapping, reverseNodeMapping);
+        remapPointsToSets();
+    }
+
+    const u64_t savedWords = remap ? result.oldWords - result.newWords : 0;
+    result.stats[NodeIDAllocator::Clusterer::RemapOldWords] = std::to_string(result.oldWords);
+    result.stats[NodeIDAllocator::Clusterer::RemapSavedBits] = std::to_string(savedWords * NATIVE_INT_SIZE);
+    NodeIDAllocator::Clusterer::printStats("online-" + std::to_string(numOfOnlineRemaps) + ": remap", result.stats);
+}
+
 void FlowSensitive::plainMap(void) const
 {
     assert(Options::NodeAllocStrat == NodeIDAllocator::Strategy::DENSE
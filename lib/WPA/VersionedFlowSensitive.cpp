@@ -571,6 +571,8 @@ void VersionedFlowSensitive::processNode(NodeID n)
     {
         propagate(&sn);
     }
+
+    reclusterOnline();
 }
 
 void VersionedFlowSensitive::updateConnectedNodes(const SVFGEdgeSetTy& newEdges)
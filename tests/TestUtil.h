@@ -0,0 +1,92 @@
+//===- TestUtil.h -- Helpers shared by the tests ---------------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===----------------------------------------------------------------------===//
+
+/*
+ * TestUtil.h
+ *
+ * Checks, command line options and modules parsed from textual IR, for the
+ * test programs (each a main returning non-zero on failure).
+ */
+
+#ifndef TESTUTIL_H_
+#define TESTUTIL_H_
+
+#include "SVF-FE/LLVMModule.h"
+#include "Util/SVFUtil.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/Support/SourceMgr.h"
+#include <functional>
+
+/// Print the failed condition and return 1 from the enclosing function
+#define CHECK(cond) \
+    do { if (!(cond)) { SVF::SVFUtil::errs() << __FILE__ << ":" << __LINE__ << ": check failed: " #cond "\n"; return 1; } } while (0)
+
+namespace SVF
+{
+
+namespace TestUtil
+{
+
+/// Set the options as given on the command line, the others being reset to their defaults
+inline void setOptions(const std::vector<std::string>& opts)
+{
+    llvm::cl::ResetAllOptionOccurrences();
+    std::vector<const char*> argv(1, "svf-test");
+    for (const std::string& opt : opts)
+        argv.push_back(opt.c_str());
+    llvm::cl::ParseCommandLineOptions(argv.size(), argv.data());
+}
+
+/// Parse textual IR into mod and build the SVFModule of it (nullptr if the IR does not parse)
+inline SVFModule* buildSVFModule(const char* ir, llvm::LLVMContext& cxt, std::unique_ptr<llvm::Module>& mod)
+{
+    llvm::SMDiagnostic err;
+    mod = llvm::parseAssemblyString(ir, err, cxt);
+    if (mod == nullptr)
+    {
+        err.print("svf-test", SVFUtil::errs());
+        return nullptr;
+    }
+    return LLVMModuleSet::getLLVMModuleSet()->buildSVFModule(*mod);
+}
+
+/// Run a function when leaving the scope, e.g., to clean up whichever CHECK returns
+class ScopeExit
+{
+public:
+    explicit ScopeExit(std::function<void()> f): f(std::move(f)) {}
+    ScopeExit(const ScopeExit&) = delete;
+    ScopeExit& operator=(const ScopeExit&) = delete;
+    ~ScopeExit()
+    {
+        f();
+    }
+
+private:
+    std::function<void()> f;
+};
+
+} // End namespace TestUtil
+
+} // End namespace SVF
+
+#endif /* TESTUTIL_H_ */
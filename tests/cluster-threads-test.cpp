@@ -0,0 +1,144 @@
+//===- cluster-threads-test.cpp -- Objects clustered on several threads -------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ // The node mappings of every clustering method, and the best one, are the
+ // same whatever the number of -cluster-threads, and single linkage over
+ // sparse distances (-cluster-max-matrix-objects) gives the distance matrix's
+ */
+
+#include "MemoryModel/PointsTo.h"
+#include "Util/NodeIDAllocator.h"
+#include "Util/Options.h"
+#include "TestUtil.h"
+
+using namespace llvm;
+using namespace SVF;
+
+typedef std::vector<std::pair<hclust_fast_methods, std::vector<NodeID>>> Candidates;
+
+/// Set the options as given on the command line, with the dense strategy which clustering requires
+static void setOptions(const std::string& threadsOpt, const std::string& maxMatrixOpt = "-cluster-max-matrix-objects=0",
+                       const std::string& methodOpt = "-cluster-method=best")
+{
+    TestUtil::setOptions({"-node-alloc-strat=dense", threadsOpt, maxMatrixOpt, methodOpt});
+}
+
+/// Points-to sets of 2 to 6 objects picked (deterministically) from each group of objects
+static Map<PointsTo, unsigned> getPointsToSets(const std::vector<std::vector<NodeID>>& groups, u32_t setsPerGroup)
+{
+    Map<PointsTo, unsigned> pointsToSets;
+    u64_t seed = 12345;
+    auto next = [&seed]()
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<u32_t>(seed >> 33);
+    };
+    for (const std::vector<NodeID>& group : groups)
+    {
+        for (u32_t i = 0; i < setsPerGroup; ++i)
+        {
+            PointsTo pts;
+            // Neighbours are in a common set, so that the group is one region
+            pts.set(group[i % group.size()]);
+            pts.set(group[(i + 1) % group.size()]);
+            for (u32_t n = next() % 5; n > 0; --n)
+                pts.set(group[next() % group.size()]);
+            pointsToSets[pts] += 1 + next() % 3;
+        }
+    }
+    return pointsToSets;
+}
+
+/// Check that clustering on several threads gives the serial mappings
+static int checkThreads(const Map<PointsTo, unsigned>& pointsToSets)
+{
+    setOptions("-cluster-threads=1");
+    Candidates serialCandidates;
+    NodeIDAllocator::Clusterer::StatsList stats;
+    std::vector<NodeID> serialBest = NodeIDAllocator::Clusterer::cluster(pointsToSets, serialCandidates, "serial", &stats);
+    // Single, complete and average linkage
+    CHECK(serialCandidates.size() == 3);
+    CHECK(serialBest.size() >= NodeIDAllocator::get()->getNumObjects());
+
+    for (u32_t threads : {2, 4, 16})
+    {
+        setOptions("-cluster-threads=" + std::to_string(threads));
+        Candidates threadedCandidates;
+        std::vector<NodeID> threadedBest = NodeIDAllocator::Clusterer::cluster(pointsToSets, threadedCandidates, "threaded", &stats);
+        CHECK(threadedBest == serialBest);
+        CHECK(threadedCandidates == serialCandidates);
+    }
+    return 0;
+}
+
+/// Check that single linkage gives the same mapping from sparse distances as from the distance matrix
+static int checkSparse(const Map<PointsTo, unsigned>& pointsToSets)
+{
+    NodeIDAllocator::Clusterer::StatsList stats;
+    setOptions("-cluster-threads=1", "-cluster-max-matrix-objects=0", "-cluster-method=single");
+    Candidates denseCandidates;
+    std::vector<NodeID> denseBest = NodeIDAllocator::Clusterer::cluster(pointsToSets, denseCandidates, "dense", &stats);
+    CHECK(stats.back().second["NumSparseRegions"] == "0");
+
+    for (u32_t threads : {1, 4})
+    {
+        setOptions("-cluster-threads=" + std::to_string(threads), "-cluster-max-matrix-objects=64", "-cluster-method=single");
+        Candidates sparseCandidates;
+        std::vector<NodeID> sparseBest = NodeIDAllocator::Clusterer::cluster(pointsToSets, sparseCandidates, "sparse", &stats);
+        CHECK(stats.back().second["NumSparseRegions"] != "0");
+        CHECK(sparseBest == denseBest);
+        CHECK(sparseCandidates == denseCandidates);
+    }
+    return 0;
+}
+
+int main()
+{
+    // Objects are numbered contiguously with the dense strategy, which clustering requires
+    setOptions("-cluster-threads=1");
+    std::vector<std::vector<NodeID>> groups(3);
+    const u32_t groupSizes[] = {150, 70, 100};
+    for (u32_t g = 0; g < groups.size(); ++g)
+    {
+        for (u32_t i = 0; i < groupSizes[g]; ++i)
+            groups[g].push_back(NodeIDAllocator::get()->allocateObjectId());
+    }
+
+    // Regions clustered by different threads
+    if (checkThreads(getPointsToSets(groups, 200)))
+        return 1;
+    if (checkSparse(getPointsToSets(groups, 200)))
+        return 1;
+
+    // A lone region worth clustering, whose distance matrix is filled by all threads
+    std::vector<std::vector<NodeID>> allObjects(1);
+    for (const std::vector<NodeID>& group : groups)
+        allObjects[0].insert(allObjects[0].end(), group.begin(), group.end());
+    if (checkThreads(getPointsToSets(allObjects, 600)))
+        return 1;
+    if (checkSparse(getPointsToSets(allObjects, 600)))
+        return 1;
+
+    NodeIDAllocator::unset();
+    return 0;
+}
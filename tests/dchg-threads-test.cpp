@@ -0,0 +1,173 @@
+//===- dchg-threads-test.cpp -- DCHG aggregates flattened on several threads --//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ // The flattened fields and contained aggregates of the DCHG built with
+ // -dchg-threads are the serially built ones
+ */
+
+#include "SVF-FE/LLVMUtil.h"
+#include "SVF-FE/DCHG.h"
+#include "Util/Options.h"
+#include "TestUtil.h"
+
+using namespace llvm;
+using namespace SVF;
+
+/// struct Inner { int x; int *p; };
+/// struct Pair { Inner a, b; };
+/// struct Outer { Pair pr; Inner arr[2]; char c; };
+/// class Base { int bx; };
+/// class Derived : Base { int d; };
+/// union U { int i; Inner in; };
+static const char* const TestIR = R"IR(
+%struct.Inner = type { i32, i32* }
+%struct.Pair = type { %struct.Inner, %struct.Inner }
+%struct.Outer = type { %struct.Pair, [2 x %struct.Inner], i8 }
+%class.Base = type { i32 }
+%class.Derived = type { %class.Base, i32 }
+%union.U = type { %struct.Inner }
+
+@outer = global %struct.Outer zeroinitializer, align 8, !dbg !0
+@derived = global %class.Derived zeroinitializer, align 4, !dbg !2
+@u = global %union.U zeroinitializer, align 8, !dbg !4
+
+define i32 @main() !dbg !90 {
+entry:
+  ret i32 0, !dbg !93
+}
+
+!llvm.dbg.cu = !{!6}
+!llvm.module.flags = !{!98, !99}
+
+!0 = !DIGlobalVariableExpression(var: !1, expr: !DIExpression())
+!1 = distinct !DIGlobalVariable(name: "outer", scope: !6, file: !7, line: 3, type: !50, isLocal: false, isDefinition: true)
+!2 = !DIGlobalVariableExpression(var: !3, expr: !DIExpression())
+!3 = distinct !DIGlobalVariable(name: "derived", scope: !6, file: !7, line: 5, type: !70, isLocal: false, isDefinition: true)
+!4 = !DIGlobalVariableExpression(var: !5, expr: !DIExpression())
+!5 = distinct !DIGlobalVariable(name: "u", scope: !6, file: !7, line: 6, type: !80, isLocal: false, isDefinition: true)
+!6 = distinct !DICompileUnit(language: DW_LANG_C_plus_plus_14, file: !7, producer: "dchg-threads-test", isOptimized: false, runtimeVersion: 0, emissionKind: FullDebug, globals: !8)
+!7 = !DIFile(filename: "dchg.cpp", directory: "/tmp")
+!8 = !{!0, !2, !4}
+
+!11 = !DIBasicType(name: "int", size: 32, encoding: DW_ATE_signed)
+!12 = !DIBasicType(name: "char", size: 8, encoding: DW_ATE_signed_char)
+!13 = !DIDerivedType(tag: DW_TAG_pointer_type, baseType: !11, size: 64)
+
+!20 = distinct !DICompositeType(tag: DW_TAG_structure_type, name: "Inner", file: !7, line: 1, size: 128, elements: !21, identifier: "_ZTS5Inner")
+!21 = !{!22, !23}
+!22 = !DIDerivedType(tag: DW_TAG_member, name: "x", scope: !20, file: !7, line: 1, baseType: !11, size: 32)
+!23 = !DIDerivedType(tag: DW_TAG_member, name: "p", scope: !20, file: !7, line: 1, baseType: !13, size: 64, offset: 64)
+
+!30 = distinct !DICompositeType(tag: DW_TAG_structure_type, name: "Pair", file: !7, line: 2, size: 256, elements: !31, identifier: "_ZTS4Pair")
+!31 = !{!32, !33}
+!32 = !DIDerivedType(tag: DW_TAG_member, name: "a", scope: !30, file: !7, line: 2, baseType: !20, size: 128)
+!33 = !DIDerivedType(tag: DW_TAG_member, name: "b", scope: !30, file: !7, line: 2, baseType: !20, size: 128, offset: 128)
+
+!40 = !DICompositeType(tag: DW_TAG_array_type, baseType: !20, size: 256, elements: !41)
+!41 = !{!42}
+!42 = !DISubrange(count: 2)
+
+!50 = distinct !DICompositeType(tag: DW_TAG_structure_type, name: "Outer", file: !7, line: 3, size: 576, elements: !51, identifier: "_ZTS5Outer")
+!51 = !{!52, !53, !54}
+!52 = !DIDerivedType(tag: DW_TAG_member, name: "pr", scope: !50, file: !7, line: 3, baseType: !30, size: 256)
+!53 = !DIDerivedType(tag: DW_TAG_member, name: "arr", scope: !50, file: !7, line: 3, baseType: !40, size: 256, offset: 256)
+!54 = !DIDerivedType(tag: DW_TAG_member, name: "c", scope: !50, file: !7, line: 3, baseType: !12, size: 8, offset: 512)
+
+!60 = distinct !DICompositeType(tag: DW_TAG_class_type, name: "Base", file: !7, line: 4, size: 32, elements: !61, identifier: "_ZTS4Base")
+!61 = !{!62}
+!62 = !DIDerivedType(tag: DW_TAG_member, name: "bx", scope: !60, file: !7, line: 4, baseType: !11, size: 32)
+
+!70 = distinct !DICompositeType(tag: DW_TAG_class_type, name: "Derived", file: !7, line: 5, size: 64, elements: !71, identifier: "_ZTS7Derived")
+!71 = !{!72, !73}
+!72 = !DIDerivedType(tag: DW_TAG_inheritance, scope: !70, baseType: !60, extraData: i32 0)
+!73 = !DIDerivedType(tag: DW_TAG_member, name: "d", scope: !70, file: !7, line: 5, baseType: !11, size: 32, offset: 32)
+
+!80 = distinct !DICompositeType(tag: DW_TAG_union_type, name: "U", file: !7, line: 6, size: 128, elements: !81, identifier: "_ZTS1U")
+!81 = !{!82, !83}
+!82 = !DIDerivedType(tag: DW_TAG_member, name: "i", scope: !80, file: !7, line: 6, baseType: !11, size: 32)
+!83 = !DIDerivedType(tag: DW_TAG_member, name: "in", scope: !80, file: !7, line: 6, baseType: !20, size: 128)
+
+!90 = distinct !DISubprogram(name: "main", scope: !7, file: !7, line: 7, type: !91, scopeLine: 7, spFlags: DISPFlagDefinition, unit: !6)
+!91 = !DISubroutineType(types: !92)
+!92 = !{!11}
+!93 = !DILocation(line: 7, scope: !90)
+
+!98 = !{i32 7, !"Dwarf Version", i32 4}
+!99 = !{i32 2, !"Debug Info Version", i32 3}
+)IR";
+
+int main()
+{
+    LLVMContext cxt;
+    std::unique_ptr<Module> mod;
+    SVFModule* svfModule = TestUtil::buildSVFModule(TestIR, cxt, mod);
+    CHECK(svfModule != nullptr);
+
+    // The aggregates of the module, by name (the array has none)
+    DebugInfoFinder finder;
+    finder.processModule(*mod);
+    Map<std::string, const DICompositeType*> types;
+    std::vector<const DICompositeType*> aggs;
+    for (const DIType* type : finder.types())
+    {
+        if (const DICompositeType* compositeType = SVFUtil::dyn_cast<DICompositeType>(type))
+        {
+            types[compositeType->getName().str()] = compositeType;
+            if (compositeType->getTag() != dwarf::DW_TAG_union_type)
+                aggs.push_back(compositeType);
+        }
+    }
+    CHECK(types.size() == 7 && aggs.size() == 6);
+
+    TestUtil::setOptions({"-dchg-threads=1"});
+    DCHGraph serialCHG(svfModule);
+    serialCHG.buildCHG(true);
+
+    // Aggregates are flattened recursively, arrays of aggregates into their element
+    CHECK(serialCHG.getNumFields(types["Inner"]) == 2);
+    CHECK(serialCHG.getNumFields(types["Pair"]) == 4);
+    CHECK(serialCHG.getNumFields(types["Outer"]) == 7);
+    CHECK(serialCHG.getNumFields(types["Derived"]) == 2);
+    CHECK(serialCHG.getAggs(types["Outer"]).size() == 3);
+    CHECK(serialCHG.getAggs(types["Outer"]).count(serialCHG.getCanonicalType(types["Inner"])) == 1);
+    CHECK(serialCHG.getAggs(types["Inner"]).empty());
+
+    for (const char* opt : {"-dchg-threads=2", "-dchg-threads=4", "-dchg-threads=16"})
+    {
+        TestUtil::setOptions({opt});
+        DCHGraph threadedCHG(svfModule);
+        threadedCHG.buildCHG(true);
+        CHECK(threadedCHG.getTotalNodeNum() == serialCHG.getTotalNodeNum());
+        CHECK(threadedCHG.getTotalEdgeNum() == serialCHG.getTotalEdgeNum());
+        for (const DICompositeType* agg : aggs)
+        {
+            CHECK(threadedCHG.getCanonicalType(agg) == serialCHG.getCanonicalType(agg));
+            CHECK(threadedCHG.getAggs(agg) == serialCHG.getAggs(agg));
+            if (agg->getTag() != dwarf::DW_TAG_array_type)
+                CHECK(threadedCHG.getFieldTypes(agg) == serialCHG.getFieldTypes(agg));
+        }
+    }
+
+    LLVMModuleSet::releaseLLVMModuleSet();
+    return 0;
+}
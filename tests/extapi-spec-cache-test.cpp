@@ -0,0 +1,169 @@
+//===- extapi-spec-cache-test.cpp -- Tests of the -ext-api-spec cache ---------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ // Round trip of the external function summaries of -ext-api-spec through
+ // the binary cache of -ext-api-spec-cache
+ */
+
+#include "SVF-FE/LLVMUtil.h"
+#include "Util/ExtAPI.h"
+#include "Util/Options.h"
+#include "TestUtil.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+
+using namespace llvm;
+using namespace SVF;
+
+static const char* const TestIR = R"IR(
+declare i8* @svf_test_a(i64)
+declare void @svf_test_b(i8*)
+
+define i8* @svf_test_def(i64 %n) {
+entry:
+  ret i8* null
+}
+
+define i32 @main() {
+entry:
+  %p = call i8* @svf_test_a(i64 8)
+  call void @svf_test_b(i8* %p)
+  %q = call i8* @svf_test_def(i64 8)
+  ret i32 0
+}
+)IR";
+
+/// Write text to a file, with the given modification time if mtime is not null
+static bool writeFile(const std::string& path, const std::string& text, const sys::TimePoint<>* mtime = nullptr)
+{
+    int fd;
+    if (sys::fs::openFileForWrite(path, fd))
+        return false;
+    raw_fd_ostream os(fd, true);
+    os << text;
+    os.flush();
+    if (mtime && sys::fs::setLastAccessAndModificationTime(fd, *mtime, *mtime))
+        return false;
+    return !os.has_error();
+}
+
+static sys::TimePoint<> getModificationTime(const std::string& path)
+{
+    sys::fs::file_status status;
+    sys::fs::status(path, status);
+    return status.getLastModificationTime();
+}
+
+/// Load the summaries again, as a new run of SVF would
+static ExtAPI* reloadExtAPI()
+{
+    ExtAPI::destory();
+    return ExtAPI::getExtAPI();
+}
+
+int main()
+{
+    SmallString<128> dir;
+    CHECK(!sys::fs::createUniqueDirectory("svf-extapi-test", dir));
+    SmallString<128> specFile(dir), cacheFile(dir);
+    sys::path::append(specFile, "spec.txt");
+    sys::path::append(cacheFile, "spec.cache");
+    // Removed however the test ends, e.g., on a failed check
+    TestUtil::ScopeExit removeDir([&]()
+    {
+        sys::fs::remove(cacheFile);
+        sys::fs::remove(specFile);
+        sys::fs::remove(dir);
+    });
+
+    // Both specs have the same size, so that only their text tells them apart
+    const std::string spec = "svf_test_a EFT_ALLOC\nsvf_test_b EFT_NOOP # frees nothing\nsvf_test_def EFT_ALLOC\n";
+    const std::string swappedSpec = "svf_test_b EFT_ALLOC\nsvf_test_a EFT_NOOP # frees nothing\nsvf_test_def EFT_ALLOC\n";
+    CHECK(spec.size() == swappedSpec.size());
+    CHECK(writeFile(specFile.str().str(), spec));
+
+    TestUtil::setOptions({"-ext-api-spec=" + specFile.str().str(), "-ext-api-spec-cache=" + cacheFile.str().str()});
+
+    LLVMContext cxt;
+    std::unique_ptr<Module> mod;
+    // Loads the summaries and writes the cache
+    CHECK(TestUtil::buildSVFModule(TestIR, cxt, mod) != nullptr);
+    CHECK(sys::fs::exists(cacheFile));
+
+    const SVFFunction* a = LLVMModuleSet::getLLVMModuleSet()->getSVFFunction(mod->getFunction("svf_test_a"));
+    const SVFFunction* b = LLVMModuleSet::getLLVMModuleSet()->getSVFFunction(mod->getFunction("svf_test_b"));
+    const SVFFunction* def = LLVMModuleSet::getLLVMModuleSet()->getSVFFunction(mod->getFunction("svf_test_def"));
+    ExtAPI* extAPI = ExtAPI::getExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_ALLOC);
+    CHECK(extAPI->get_spec_type(b) == ExtAPI::EFT_NOOP);
+    CHECK(extAPI->is_alloc(a));
+    // Only declarations are summarised
+    CHECK(extAPI->get_spec_type(def) == ExtAPI::EFT_OTHER);
+    CHECK(!extAPI->is_alloc(def));
+
+    // Same spec file: the summaries read back from the cache are the parsed ones
+    extAPI = reloadExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_ALLOC);
+    CHECK(extAPI->get_spec_type(b) == ExtAPI::EFT_NOOP);
+    CHECK(extAPI->get_spec_type(def) == ExtAPI::EFT_OTHER);
+
+    // Same size and modification time but another text: the spec is parsed and cached again
+    sys::TimePoint<> mtime = getModificationTime(specFile.str().str());
+    CHECK(writeFile(specFile.str().str(), swappedSpec, &mtime));
+    CHECK(getModificationTime(specFile.str().str()) == mtime);
+    extAPI = reloadExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_NOOP);
+    CHECK(extAPI->get_spec_type(b) == ExtAPI::EFT_ALLOC);
+    extAPI = reloadExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_NOOP);
+    CHECK(extAPI->get_spec_type(b) == ExtAPI::EFT_ALLOC);
+
+    // A new modification time only: the cache is still used, and not rewritten
+    sys::TimePoint<> later = mtime + std::chrono::seconds(1);
+    CHECK(writeFile(specFile.str().str(), swappedSpec, &later));
+    std::string cached;
+    {
+        ErrorOr<std::unique_ptr<MemoryBuffer>> cache = MemoryBuffer::getFile(cacheFile);
+        CHECK(cache);
+        cached = (*cache)->getBuffer().str();
+    }
+    sys::TimePoint<> cacheTime = mtime - std::chrono::hours(1);
+    CHECK(writeFile(cacheFile.str().str(), cached, &cacheTime));
+    extAPI = reloadExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_NOOP);
+    CHECK(extAPI->get_spec_type(b) == ExtAPI::EFT_ALLOC);
+    CHECK(getModificationTime(cacheFile.str().str()) == cacheTime);
+
+    // A corrupt cache is ignored and rewritten
+    CHECK(writeFile(cacheFile.str().str(), "not a cache"));
+    extAPI = reloadExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_NOOP);
+    CHECK(extAPI->get_spec_type(b) == ExtAPI::EFT_ALLOC);
+    extAPI = reloadExtAPI();
+    CHECK(extAPI->get_spec_type(a) == ExtAPI::EFT_NOOP);
+
+    ExtAPI::destory();
+    LLVMModuleSet::releaseLLVMModuleSet();
+    return 0;
+}
@@ -0,0 +1,96 @@
+//===- flatindexmap-test.cpp -- Tests of FlatIndexMap -------------------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ // Lookups, insertion order and growth of FlatIndexMap
+ */
+
+#include "Util/FlatIndexMap.h"
+#include "TestUtil.h"
+
+using namespace SVF;
+
+int main()
+{
+    FlatIndexMap<u32_t, u32_t> map;
+    CHECK(map.empty());
+    CHECK(map.find(1) == map.end());
+    CHECK(map.count(1) == 0);
+
+    // Ids inserted out of order (and enough of them to grow the table several times)
+    const u32_t numKeys = 1000;
+    for (u32_t i = 0; i < numKeys; ++i)
+    {
+        u32_t key = (i * 7919) % numKeys;
+        std::pair<FlatIndexMap<u32_t, u32_t>::iterator, bool> res = map.insert(std::make_pair(key, i));
+        CHECK(res.second);
+        CHECK(res.first->first == key && res.first->second == i);
+    }
+    CHECK(map.size() == numKeys);
+
+    // Inserting an existing key keeps the first value
+    std::pair<FlatIndexMap<u32_t, u32_t>::iterator, bool> res = map.insert(std::make_pair(0, 42));
+    CHECK(!res.second);
+    CHECK(res.first->second == 0);
+    CHECK(map.size() == numKeys);
+
+    for (u32_t key = 0; key < numKeys; ++key)
+    {
+        CHECK(map.count(key) == 1);
+        FlatIndexMap<u32_t, u32_t>::const_iterator it = map.find(key);
+        CHECK(it != map.end() && it->first == key);
+        CHECK((it->second * 7919) % numKeys == key);
+    }
+    CHECK(map.count(numKeys) == 0);
+
+    // Iteration follows the insertion order
+    u32_t i = 0;
+    for (const FlatIndexMap<u32_t, u32_t>::value_type& entry : map)
+    {
+        CHECK(entry.first == (i * 7919) % numKeys && entry.second == i);
+        ++i;
+    }
+    CHECK(i == numKeys);
+
+    // operator[] finds existing entries and default-constructs new ones
+    map[5] = 12345;
+    CHECK(map.find(5)->second == 12345);
+    CHECK(map[numKeys] == 0);
+    CHECK(map.size() == numKeys + 1);
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.find(5) == map.end());
+    map[3] = 4;
+    CHECK(map.size() == 1 && map.begin()->first == 3 && map.begin()->second == 4);
+
+    // Pointer keys
+    int objs[3];
+    FlatIndexMap<const int*, u32_t> ptrMap;
+    ptrMap[&objs[2]] = 2;
+    ptrMap[&objs[0]] = 0;
+    CHECK(ptrMap.count(&objs[1]) == 0);
+    CHECK(ptrMap.find(&objs[2])->second == 2);
+    CHECK(ptrMap.begin()->first == &objs[2]);
+
+    return 0;
+}
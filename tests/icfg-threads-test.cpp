@@ -0,0 +1,150 @@
+//===- icfg-threads-test.cpp -- ICFG built on several threads -----------------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ // The ICFG built with -icfg-build-threads is the serially built one,
+ // node ids included
+ */
+
+#include "SVF-FE/LLVMUtil.h"
+#include "SVF-FE/ICFGBuilder.h"
+#include "Graphs/ICFG.h"
+#include "Util/Options.h"
+#include "TestUtil.h"
+
+using namespace llvm;
+using namespace SVF;
+
+static const char* const TestIR = R"IR(
+@fp = global i32 (i32)* @inc
+
+declare i8* @malloc(i64)
+
+define i32 @inc(i32 %x) {
+entry:
+  %r = add i32 %x, 1
+  ret i32 %r
+}
+
+define i32 @fact(i32 %n) {
+entry:
+  %c = icmp sle i32 %n, 1
+  br i1 %c, label %base, label %rec
+base:
+  ret i32 1
+rec:
+  %m = sub i32 %n, 1
+  %f = call i32 @fact(i32 %m)
+  %r = mul i32 %n, %f
+  ret i32 %r
+}
+
+define i32 @loop(i32 %n) {
+entry:
+  br label %head
+head:
+  %i = phi i32 [ 0, %entry ], [ %j, %body ]
+  %s = phi i32 [ 0, %entry ], [ %t, %body ]
+  %c = icmp slt i32 %i, %n
+  br i1 %c, label %body, label %exit
+body:
+  %t = call i32 @inc(i32 %s)
+  %j = add i32 %i, 1
+  br label %head
+exit:
+  ret i32 %s
+}
+
+define i32 @pick(i32 %k) {
+entry:
+  switch i32 %k, label %other [
+    i32 0, label %zero
+    i32 1, label %one
+  ]
+zero:
+  br label %done
+one:
+  %f = load i32 (i32)*, i32 (i32)** @fp
+  %v = call i32 %f(i32 %k)
+  br label %done
+other:
+  %p = call i8* @malloc(i64 4)
+  br label %done
+dead:
+  br label %done
+done:
+  %r = phi i32 [ 0, %zero ], [ %v, %one ], [ 2, %other ], [ 3, %dead ]
+  ret i32 %r
+}
+
+define i32 @main() {
+entry:
+  %a = call i32 @fact(i32 5)
+  %b = call i32 @loop(i32 %a)
+  %c = call i32 @pick(i32 %b)
+  %d = call i32 @inc(i32 %c)
+  ret i32 %d
+}
+)IR";
+
+/// The nodes of an ICFG and their outgoing edges in id order
+static std::string dumpICFG(ICFG* icfg)
+{
+    std::string str;
+    raw_string_ostream rawstr(str);
+    for (NodeID id = 0; id < icfg->getTotalNodeNum(); ++id)
+    {
+        ICFGNode* node = icfg->getICFGNode(id);
+        rawstr << node->toString() << "\n";
+        for (const ICFGEdge* edge : node->getOutEdges())
+            rawstr << "\t" << edge->toString() << "\n";
+    }
+    return rawstr.str();
+}
+
+int main()
+{
+    LLVMContext cxt;
+    std::unique_ptr<Module> mod;
+    SVFModule* svfModule = TestUtil::buildSVFModule(TestIR, cxt, mod);
+    CHECK(svfModule != nullptr);
+
+    TestUtil::setOptions({"-icfg-build-threads=1"});
+    ICFG serialICFG;
+    ICFGBuilder(&serialICFG).build(svfModule);
+    std::string serial = dumpICFG(&serialICFG);
+    // Global node, entry/exit of 5 functions, and the nodes of the instructions
+    CHECK(serialICFG.getTotalNodeNum() > 11);
+
+    for (const char* opt : {"-icfg-build-threads=2", "-icfg-build-threads=4", "-icfg-build-threads=16"})
+    {
+        TestUtil::setOptions({opt});
+        ICFG threadedICFG;
+        ICFGBuilder(&threadedICFG).build(svfModule);
+        CHECK(threadedICFG.getTotalNodeNum() == serialICFG.getTotalNodeNum());
+        CHECK(threadedICFG.getTotalEdgeNum() == serialICFG.getTotalEdgeNum());
+        CHECK(dumpICFG(&threadedICFG) == serial);
+    }
+
+    LLVMModuleSet::releaseLLVMModuleSet();
+    return 0;
+}
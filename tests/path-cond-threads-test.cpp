@@ -0,0 +1,154 @@
+//===- path-cond-threads-test.cpp -- Path conditions on several threads ------//
+//
+//                     SVF: Static Value-Flow Analysis
+//
+// Copyright (C) <2013-2017>  <Yulei Sui>
+//
+
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+//===-----------------------------------------------------------------------===//
+
+/*
+ // The path conditions allocated with -path-cond-threads, by per-thread
+ // condition managers, are the serially allocated ones
+ */
+
+#include "SVF-FE/LLVMUtil.h"
+#include "SABER/PathCondAllocator.h"
+#include "Util/Options.h"
+#include "TestUtil.h"
+
+using namespace llvm;
+using namespace SVF;
+
+static const char* const TestIR = R"IR(
+define i32 @diamond(i32 %x) {
+entry:
+  %c = icmp sgt i32 %x, 0
+  br i1 %c, label %then, label %else
+then:
+  %d = icmp sgt i32 %x, 10
+  br i1 %d, label %big, label %join
+big:
+  br label %join
+else:
+  br label %join
+join:
+  %r = phi i32 [ 1, %then ], [ 2, %big ], [ 3, %else ]
+  ret i32 %r
+}
+
+define i32 @loop(i32 %n) {
+entry:
+  br label %head
+head:
+  %i = phi i32 [ 0, %entry ], [ %j, %body ]
+  %c = icmp slt i32 %i, %n
+  br i1 %c, label %body, label %exit
+body:
+  %j = add i32 %i, 1
+  %e = icmp eq i32 %j, 7
+  br i1 %e, label %exit, label %head
+exit:
+  ret i32 %i
+}
+
+define i32 @pick(i32 %k) {
+entry:
+  switch i32 %k, label %other [
+    i32 0, label %zero
+    i32 1, label %one
+    i32 2, label %two
+    i32 3, label %three
+  ]
+zero:
+  br label %done
+one:
+  br label %done
+two:
+  br label %done
+three:
+  %c = icmp eq i32 %k, 3
+  br i1 %c, label %done, label %other
+other:
+  br label %done
+done:
+  %r = phi i32 [ 0, %zero ], [ 1, %one ], [ 2, %two ], [ 3, %three ], [ 4, %other ]
+  ret i32 %r
+}
+
+define i32 @main() {
+entry:
+  %a = call i32 @diamond(i32 5)
+  %b = call i32 @loop(i32 %a)
+  %c = call i32 @pick(i32 %b)
+  ret i32 %c
+}
+)IR";
+
+/// The guards from the entry of each function to its basic blocks, allocated with the given option
+static std::vector<PathCondAllocator::Condition*> getGuards(SVFModule* svfModule, const char* opt, PathCondAllocator& pca)
+{
+    TestUtil::setOptions({opt});
+    // Condition variables are numbered from 0 again, so that both allocations name the same branches alike
+    CondManager::totalCondNum = 0;
+    pca.allocate(svfModule);
+    std::vector<PathCondAllocator::Condition*> guards;
+    for (const SVFFunction* fun : *svfModule)
+    {
+        if (SVFUtil::isExtCall(fun))
+            continue;
+        const BasicBlock* entry = &fun->getLLVMFun()->getEntryBlock();
+        for (const BasicBlock& bb : *fun->getLLVMFun())
+            guards.push_back(pca.ComputeIntraVFGGuard(entry, &bb));
+    }
+    return guards;
+}
+
+int main()
+{
+    LLVMContext cxt;
+    std::unique_ptr<Module> mod;
+    SVFModule* svfModule = TestUtil::buildSVFModule(TestIR, cxt, mod);
+    CHECK(svfModule != nullptr);
+
+    PathCondAllocator serialPCA;
+    std::vector<PathCondAllocator::Condition*> serial = getGuards(svfModule, "-path-cond-threads=1", serialPCA);
+    // The guards of the branches are neither true nor false
+    u32_t numBranchGuards = 0;
+    for (PathCondAllocator::Condition* guard : serial)
+    {
+        if (guard != serialPCA.getTrueCond() && guard != serialPCA.getFalseCond())
+            ++numBranchGuards;
+    }
+    CHECK(numBranchGuards > 5);
+
+    for (const char* opt : {"-path-cond-threads=2", "-path-cond-threads=4", "-path-cond-threads=16"})
+    {
+        // Both allocators use the global condition manager, into which the threaded conditions are translated
+        PathCondAllocator threadedPCA;
+        std::vector<PathCondAllocator::Condition*> threaded = getGuards(svfModule, opt, threadedPCA);
+        CHECK(threaded.size() == serial.size());
+        for (u32_t i = 0; i < serial.size(); ++i)
+        {
+            CHECK(threadedPCA.isEquivalentBranchCond(threaded[i], serial[i]));
+            CHECK(threadedPCA.dumpCond(threaded[i]) == serialPCA.dumpCond(serial[i]));
+        }
+    }
+
+    CondManager::releaseCondMgr();
+    LLVMModuleSet::releaseLLVMModuleSet();
+    return 0;
+}